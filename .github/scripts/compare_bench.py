@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Compare two countdown_bench CSV results (QtTest "-o file,csv" output).
+
+    compare_bench.py baseline.csv current.csv [--summary file] [--warn 20] [--fail 0]
+
+Writes a Markdown table (to stdout, or appended to --summary, e.g. the CI
+job summary) and prints a GitHub "::warning::" annotation for every
+benchmark that got slower than --warn percent. With --fail N the exit status is 1 if any got slower than N%.
+"""
+
+import argparse
+import csv
+import sys
+
+
+def read_results(path):
+    # Each row: "function","tag","metric",value_per_iteration,total,iterations
+    results = {}
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            if len(row) < 4:
+                continue
+            try:
+                value = float(row[3])
+            except ValueError:
+                continue  # Header or a non-benchmark line
+            name = row[0] + (f" [{row[1]}]" if row[1] else "")
+            results[name] = (value, row[2])
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--summary")
+    parser.add_argument("--warn", type=float, default=20.0)
+    parser.add_argument("--fail", type=float, default=0.0)
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    current = read_results(args.current)
+
+    table = ["| Benchmark | Baseline | Current | Change |", "| --- | ---: | ---: | ---: |"]
+    failed = False
+    for name, (value, metric) in sorted(current.items()):
+        if name not in baseline or baseline[name][0] <= 0:
+            table.append(f"| {name} | - | {value:.4g} {metric} | new |")
+            continue
+        before = baseline[name][0]
+        change = (value - before) / before * 100
+        table.append(f"| {name} | {before:.4g} {metric} | {value:.4g} {metric} | {change:+.1f}% |")
+        if change > args.warn:
+            print(f"::warning::{name} is {change:.1f}% slower than the baseline")
+        if args.fail > 0 and change > args.fail:
+            failed = True
+
+    if args.summary:
+        with open(args.summary, "a") as f:
+            f.write("\n".join(table) + "\n")
+    else:
+        print("\n".join(table))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,42 @@
+#include "assets.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QResource>
+
+namespace Assets {
+
+QString locate(const QString &fileName) {
+    if (fileName.isEmpty()) return QString();
+    if (QFileInfo::exists(fileName)) return fileName;
+    if (QDir::isAbsolutePath(fileName)) return QString();
+
+    QString besideExecutable = QDir(QCoreApplication::applicationDirPath()).filePath(fileName);
+    if (QFileInfo::exists(besideExecutable)) return besideExecutable;
+
+    // Only the exact name of an embedded default falls back to it; anything
+    // else that is missing (a typo, another directory) is reported as such
+    QString embedded = QStringLiteral(":/defaults/") + fileName;
+    if (!QFileInfo::exists(embedded)) return QString();
+    QString transcoded = QStringLiteral(":/defaults/%1.wav").arg(QFileInfo(fileName).completeBaseName());
+    if (transcoded != embedded && QFileInfo::exists(transcoded)) return transcoded;
+    return embedded;
+}
+
+QUrl urlFor(const QString &path) {
+    if (isEmbedded(path)) return QUrl(QStringLiteral("qrc") + path);
+    return QUrl::fromLocalFile(QFileInfo(path).absoluteFilePath());
+}
+
+QByteArray mapped(const QString &path) {
+    if (!isEmbedded(path)) return QByteArray();
+    QResource resource(path);
+    if (!resource.isValid() || resource.compressionAlgorithm() != QResource::NoCompression) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(resource.data()),
+                                   qsizetype(resource.size()));
+}
+
+} // namespace Assets
@@ -0,0 +1,34 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+// Where config.txt and the sound files come from. A file on disk always
+// wins, so anything can be overridden; otherwise the copy compiled into
+// the executable (assets.qrc, under :/defaults) is used, so the program
+// works started from any directory with nothing next to it.
+namespace Assets {
+
+// fileName as given if it exists, then the same name next to the
+// executable, then the embedded default of exactly that name
+// ("sound_zero.mp3", not "cues/sound_zero.mp3"). A sound that was
+// transcoded to PCM at build time ("sound_zero.wav" for "sound_zero.mp3")
+// is preferred over its embedded original. Empty if there is none of these.
+QString locate(const QString &fileName);
+
+inline bool isEmbedded(const QString &path) {
+    return path.startsWith(QLatin1String(":/"));
+}
+
+// qrc: for embedded files, file: otherwise
+QUrl urlFor(const QString &path);
+
+// The bytes of an uncompressed embedded file, straight from the
+// executable image (no copy, no file I/O). Empty for anything else.
+QByteArray mapped(const QString &path);
+
+} // namespace Assets
+
+#endif // ASSETS_H
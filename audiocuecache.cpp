@@ -0,0 +1,261 @@
+#include "audiocuecache.h"
+
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMediaDevices>
+#include <QtEndian>
+#include <cstring>
+
+#include "assets.h"
+
+namespace {
+
+// The PCM inside a canonical RIFF/WAVE file, without copying it
+struct WavData {
+    int channels = 0;
+    int sampleRate = 0;
+    int bitsPerSample = 0;
+    QByteArray pcm;
+};
+
+bool parseWav(const QByteArray &file, WavData *wav) {
+    const char *data = file.constData();
+    qsizetype size = file.size();
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool haveFormat = false;
+    qsizetype offset = 12;
+    while (offset + 8 <= size) {
+        const char *chunk = data + offset;
+        quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const char *body = chunk + 8;
+        if (qsizetype(chunkSize) > size - offset - 8) return false;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+            if (qFromLittleEndian<quint16>(body) != 1) return false; // Integer PCM only
+            wav->channels = qFromLittleEndian<quint16>(body + 2);
+            wav->sampleRate = int(qFromLittleEndian<quint32>(body + 4));
+            wav->bitsPerSample = qFromLittleEndian<quint16>(body + 14);
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) return false;
+            wav->pcm = QByteArray::fromRawData(body, qsizetype(chunkSize));
+            return true;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+} // namespace
+
+AudioCueCache::AudioCueCache(QObject *parent) : QObject(parent) {
+}
+
+void AudioCueCache::initialize() {
+    if (initialized) return;
+    initialized = true;
+
+    // Decode everything straight into the output device's format so the
+    // sinks never have to convert. 16-bit keeps the cached PCM small.
+    QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    format = device.preferredFormat();
+    QAudioFormat int16Format = format;
+    int16Format.setSampleFormat(QAudioFormat::Int16);
+    if (device.isFormatSupported(int16Format)) {
+        format = int16Format;
+    }
+
+    for (int i = 0; i < InitialVoices; ++i) {
+        addVoice();
+    }
+
+    for (CueId id = 0; id < cues.size(); ++id) {
+        startDecode(id);
+    }
+    if (pendingDecodes == 0) emit allCuesSettled();
+}
+
+AudioCueCache::~AudioCueCache() {
+    stopAll();
+}
+
+QUrl AudioCueCache::resolve(const QString &fileName, QString *error) {
+    if (fileName.isEmpty()) return QUrl();
+
+    // A file on disk, or else the default compiled into the executable
+    QString path = Assets::locate(fileName);
+    if (path.isEmpty()) {
+        if (error) *error = QString("sound file not found: %1").arg(fileName);
+        return QUrl();
+    }
+    if (!QFileInfo(path).isFile()) {
+        if (error) *error = QString("sound file is not a file: %1").arg(fileName);
+        return QUrl();
+    }
+    return Assets::urlFor(path);
+}
+
+AudioCueCache::CueId AudioCueCache::load(const QString &fileName) {
+    return load(resolve(fileName));
+}
+
+AudioCueCache::CueId AudioCueCache::load(const QUrl &source) {
+    if (source.isEmpty()) return InvalidCue;
+
+    QString key = source.toString();
+    if (cueBySource.contains(key)) return cueBySource.value(key);
+
+    CueId id = cues.size();
+    Cue cue;
+    cue.source = source;
+    cues.append(cue);
+    cueBySource.insert(key, id);
+
+    // Before initialize() the file is only remembered; decoding starts
+    // together with the audio backend.
+    if (initialized) {
+        startDecode(id);
+        // Embedded PCM is ready at once, leaving nothing to wait for
+        if (pendingDecodes == 0) emit allCuesSettled();
+    }
+    return id;
+}
+
+void AudioCueCache::startDecode(CueId id) {
+    const QUrl &source = cues[id].source;
+    QString resourcePath = source.scheme() == QLatin1String("qrc")
+                               ? QLatin1Char(':') + source.path()
+                               : QString();
+
+    // PCM transcoded at build time in the output format plays straight
+    // from the executable image: no decoder, no copy
+    WavData wav;
+    if (!resourcePath.isEmpty() && parseWav(Assets::mapped(resourcePath), &wav)
+        && format.sampleFormat() == QAudioFormat::Int16 && wav.bitsPerSample == 16
+        && wav.channels == format.channelCount() && wav.sampleRate == format.sampleRate()) {
+        cues[id].pcm = wav.pcm;
+        cues[id].ready = !wav.pcm.isEmpty();
+        if (cues[id].ready) {
+            emit cueReady(id);
+            return;
+        }
+    }
+
+    QAudioDecoder *decoder = new QAudioDecoder(this);
+    decoder->setAudioFormat(format);
+    if (resourcePath.isEmpty()) {
+        decoder->setSource(source);
+    } else {
+        // Read through QFile, which every backend can, rather than a qrc: URL
+        QFile *file = new QFile(resourcePath, decoder);
+        file->open(QIODevice::ReadOnly);
+        decoder->setSourceDevice(file);
+    }
+    cues[id].decoder = decoder;
+    pendingDecodes++;
+
+    connect(decoder, &QAudioDecoder::bufferReady, this, [this, id, decoder]() {
+        QAudioBuffer buffer = decoder->read();
+        if (buffer.isValid()) {
+            cues[id].pcm.append(buffer.constData<char>(), buffer.byteCount());
+        }
+    });
+    connect(decoder, &QAudioDecoder::finished, this, [this, id]() {
+        finishDecode(id);
+    });
+    connect(decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), this,
+            [this, id, decoder](QAudioDecoder::Error) {
+        QString message = decoder->errorString();
+        cues[id].decoder = nullptr;
+        cues[id].pcm.clear();
+        decoder->deleteLater();
+        emit cueFailed(id, message);
+        settleDecode();
+    });
+
+    decoder->start();
+}
+
+bool AudioCueCache::isReady(CueId id) const {
+    return id >= 0 && id < cues.size() && cues[id].ready;
+}
+
+bool AudioCueCache::play(CueId id, int owner) {
+    if (!isReady(id)) return false;
+
+    Voice *voice = acquireVoice();
+    voice->sink->stop();
+    voice->buffer->close();
+    voice->buffer->setData(cues[id].pcm); // Implicitly shared, no copy
+    voice->buffer->open(QIODevice::ReadOnly);
+    voice->owner = owner;
+    voice->sink->start(voice->buffer);
+    return true;
+}
+
+void AudioCueCache::stop(int owner) {
+    for (Voice &voice : voices) {
+        if (voice.owner != owner) continue;
+        voice.sink->stop();
+        voice.buffer->close();
+    }
+}
+
+void AudioCueCache::stopAll() {
+    for (Voice &voice : voices) {
+        voice.sink->stop();
+        voice.buffer->close();
+    }
+}
+
+AudioCueCache::Voice *AudioCueCache::acquireVoice() {
+    for (Voice &voice : voices) {
+        QAudio::State state = voice.sink->state();
+        if (state == QAudio::IdleState || state == QAudio::StoppedState) {
+            return &voice;
+        }
+    }
+
+    if (voices.size() < MaxVoices) {
+        addVoice();
+        return &voices.last();
+    }
+
+    // Every voice is busy: reuse the first one rather than drop the cue
+    return &voices.first();
+}
+
+void AudioCueCache::addVoice() {
+    Voice voice;
+    voice.sink = new QAudioSink(QMediaDevices::defaultAudioOutput(), format, this);
+    voice.buffer = new QBuffer(this);
+    voices.append(voice);
+}
+
+void AudioCueCache::finishDecode(CueId id) {
+    Cue &cue = cues[id];
+    if (!cue.decoder) return; // Already reported through the error signal
+    cue.decoder->deleteLater();
+    cue.decoder = nullptr;
+    cue.ready = !cue.pcm.isEmpty();
+    if (cue.ready) {
+        emit cueReady(id);
+    } else {
+        emit cueFailed(id, QStringLiteral("No audio decoded from %1")
+                               .arg(cue.source.isLocalFile() ? cue.source.toLocalFile()
+                                                             : cue.source.toString()));
+    }
+    settleDecode();
+}
+
+void AudioCueCache::settleDecode() {
+    if (--pendingDecodes == 0) emit allCuesSettled();
+}
@@ -0,0 +1,97 @@
+#ifndef AUDIOCUECACHE_H
+#define AUDIOCUECACHE_H
+
+#include <QObject>
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+class QAudioDecoder;
+class QAudioSink;
+class QBuffer;
+
+// Decodes audio cues to PCM once, up front, and plays them from memory.
+// Triggering a cue does no file I/O and no decoding: it only hands an
+// already decoded buffer to an idle QAudioSink. Each playing cue gets its
+// own voice, so overlapping cues mix instead of cutting each other off.
+// Voices are tagged with the owner that played them, so several users can
+// share one cache (and one decode per file) and still stop only their own.
+//
+// Nothing touches the multimedia backend until initialize(), so a window
+// can paint its first frame before audio comes up.
+class AudioCueCache : public QObject {
+    Q_OBJECT
+
+public:
+    using CueId = int;
+    static constexpr CueId InvalidCue = -1;
+
+    explicit AudioCueCache(QObject *parent = nullptr);
+    ~AudioCueCache() override;
+
+    // Bring up the audio output and start decoding every cue loaded so far.
+    void initialize();
+    bool isInitialized() const { return initialized; }
+
+    // Check fileName once and turn it into the source load() takes. Returns
+    // an empty QUrl if there is nothing to play, with the reason in error
+    // (left empty when fileName is empty, i.e. no sound is configured).
+    static QUrl resolve(const QString &fileName, QString *error = nullptr);
+
+    // Register fileName and decode it in the background (once initialized).
+    // Loading the same file twice returns the existing cue. Returns
+    // InvalidCue if the file does not exist.
+    CueId load(const QString &fileName);
+    // The same for a source resolve() has already checked; touches no file
+    CueId load(const QUrl &source);
+
+    bool isReady(CueId id) const;
+
+    // Play a decoded cue on a free voice. Returns false if the cue is
+    // invalid or has not finished decoding, so the caller can fall back.
+    bool play(CueId id, int owner = 0);
+    // Silence only the voices owner played; stopAll() silences all of them
+    void stop(int owner);
+    void stopAll();
+
+signals:
+    void cueReady(AudioCueCache::CueId id);
+    void cueFailed(AudioCueCache::CueId id, const QString &error);
+    // Every cue registered so far has finished decoding (or failed)
+    void allCuesSettled();
+
+private:
+    struct Cue {
+        QUrl source;
+        QByteArray pcm;
+        QAudioDecoder *decoder = nullptr;
+        bool ready = false;
+    };
+
+    struct Voice {
+        QAudioSink *sink = nullptr;
+        QBuffer *buffer = nullptr;
+        int owner = 0;
+    };
+
+    static constexpr int InitialVoices = 2;
+    static constexpr int MaxVoices = 8;
+
+    bool initialized = false;
+    int pendingDecodes = 0;
+    QAudioFormat format;
+    QList<Cue> cues;
+    QHash<QString, CueId> cueBySource;
+    QList<Voice> voices;
+
+    Voice *acquireVoice();
+    void addVoice();
+    void startDecode(CueId id);
+    void finishDecode(CueId id);
+    void settleDecode();
+};
+
+#endif // AUDIOCUECACHE_H
@@ -0,0 +1,38 @@
+#include "configwatcher.h"
+
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+ConfigWatcher::ConfigWatcher(const QString &fileName, QObject *parent)
+    : QObject(parent), filePath(QFileInfo(fileName).absoluteFilePath()) {
+    debounce = new QTimer(this);
+    debounce->setSingleShot(true);
+    debounce->setInterval(DebounceMs);
+    connect(debounce, &QTimer::timeout, this, &ConfigWatcher::changed);
+
+    watcher = new QFileSystemWatcher(this);
+    // The directory is watched too, so a file replaced by rename (or
+    // deleted and re-created) is picked up again.
+    watcher->addPath(QFileInfo(filePath).absolutePath());
+    rewatch();
+
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        rewatch();
+        debounce->start();
+    });
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        // Other files in the directory (e.g. our own snapshot) are ignored
+        if (!watcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+            rewatch();
+            debounce->start();
+        }
+    });
+}
+
+void ConfigWatcher::rewatch() {
+    // A file replaced by rename drops out of the watch list
+    if (!watcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+        watcher->addPath(filePath);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef CONFIGWATCHER_H
+#define CONFIGWATCHER_H
+
+#include <QObject>
+#include <QString>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Reports edits to a config file, debounced: editors that write a file in
+// several steps (truncate + write, or write a temp file and rename it over
+// the original) trigger one changed() signal, not one per step.
+class ConfigWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ConfigWatcher(const QString &fileName, QObject *parent = nullptr);
+
+    static constexpr int DebounceMs = 250;
+
+signals:
+    void changed();
+
+private:
+    QString filePath;
+    QFileSystemWatcher *watcher;
+    QTimer *debounce;
+
+    void rewatch();
+};
+
+#endif // CONFIGWATCHER_H
@@ -0,0 +1,372 @@
+#include "controlserver.h"
+
+#include <QCryptographicHash>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QUrl>
+#include <QUrlQuery>
+#include <atomic>
+
+#include "spscqueue.h"
+#include "timeformat.h"
+
+// Everything the two threads share. Written by one side, read by the
+// other, never locked.
+struct ControlChannel {
+    // Server thread -> GUI thread
+    SpscQueue<ControlServer::Request, ControlServer::MaxQueuedRequests> requests;
+    std::atomic<bool> requestWakePending{false};
+
+    // GUI thread -> server thread: a seqlock around the latest state. The
+    // sequence is odd while a write is in progress; a reader that sees it
+    // change retries.
+    std::atomic<quint32> sequence{0};
+    std::atomic<int> flags{0};
+    std::atomic<qint64> remainingMs{0};
+    std::atomic<qint64> capturedAtMs{0}; // Monotonic time the remaining time was taken at
+    std::atomic<qint64> startMs{0};
+    std::atomic<qint64> limitMs{0};
+    std::atomic<quint8> layout{0};
+    std::atomic<quint8> overtime{0};
+    std::atomic<bool> stateWakePending{false};
+
+    enum StateFlag { Running = 0x1, Paused = 0x2, LimitReached = 0x4 };
+
+    void writeState(const ControlServer::State &state) {
+        quint32 s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        flags.store((state.running ? Running : 0) | (state.paused ? Paused : 0)
+                        | (state.limitReached ? LimitReached : 0),
+                    std::memory_order_relaxed);
+        remainingMs.store(state.remainingMs, std::memory_order_relaxed);
+        capturedAtMs.store(QDeadlineTimer::current().deadline(), std::memory_order_relaxed);
+        startMs.store(state.startMs, std::memory_order_relaxed);
+        limitMs.store(state.limitMs, std::memory_order_relaxed);
+        layout.store(quint8(state.layout), std::memory_order_relaxed);
+        overtime.store(quint8(state.overtime), std::memory_order_relaxed);
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // The latest state, with a running timer's remaining time brought up
+    // to now
+    ControlServer::State readState() const {
+        ControlServer::State state;
+        qint64 capturedAt = 0;
+        while (true) {
+            quint32 before = sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            int f = flags.load(std::memory_order_relaxed);
+            state.running = f & Running;
+            state.paused = f & Paused;
+            state.limitReached = f & LimitReached;
+            state.remainingMs = remainingMs.load(std::memory_order_relaxed);
+            capturedAt = capturedAtMs.load(std::memory_order_relaxed);
+            state.startMs = startMs.load(std::memory_order_relaxed);
+            state.limitMs = limitMs.load(std::memory_order_relaxed);
+            state.layout = TimeLayout(layout.load(std::memory_order_relaxed));
+            state.overtime = OvertimeSign(overtime.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) break;
+        }
+
+        if (state.running) {
+            qint64 elapsed = QDeadlineTimer::current().deadline() - capturedAt;
+            state.remainingMs = qMax(state.remainingMs - elapsed, state.limitMs);
+        }
+        return state;
+    }
+};
+
+namespace {
+
+const QByteArray WebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+const int MaxRequestBytes = 8 * 1024;
+// A subscriber this far behind is dropped rather than buffered without bound
+const qint64 MaxBacklogBytes = 64 * 1024;
+
+QByteArray httpResponse(int status, const char *reason, const QByteArray &body,
+                        const QByteArray &contentType = "application/json") {
+    return "HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n"
+           + "Content-Type: " + contentType + "\r\n"
+           + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           + "Access-Control-Allow-Origin: *\r\n"
+           + "Connection: close\r\n\r\n" + body;
+}
+
+// One unmasked server frame (server frames are never masked)
+QByteArray webSocketFrame(quint8 opcode, const QByteArray &payload) {
+    QByteArray frame;
+    frame.append(char(0x80 | opcode)); // FIN + opcode
+    qsizetype size = payload.size();
+    if (size < 126) {
+        frame.append(char(size));
+    } else if (size < 65536) {
+        frame.append(char(126));
+        frame.append(char(size >> 8));
+        frame.append(char(size & 0xff));
+    } else {
+        frame.append(char(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame.append(char((quint64(size) >> shift) & 0xff));
+        }
+    }
+    return frame + payload;
+}
+
+QByteArray stateJson(const ControlServer::State &state) {
+    QJsonObject json;
+    json["running"] = state.running;
+    json["paused"] = state.paused;
+    json["limit_reached"] = state.limitReached;
+    json["remaining_ms"] = qint64(state.remainingMs);
+    json["start_ms"] = qint64(state.startMs);
+    json["limit_ms"] = qint64(state.limitMs);
+    json["text"] = formatCountdown(state.remainingMs, state.layout, state.overtime);
+    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+// Owns every socket; lives on ControlServer's thread
+class ControlWorker : public QObject {
+public:
+    ControlWorker(ControlServer *owner, ControlChannel *channel)
+        : owner(owner), channel(channel) {}
+
+    bool listen(const QHostAddress &address, quint16 port) {
+        server = new QTcpServer(this);
+        connect(server, &QTcpServer::newConnection, this, &ControlWorker::acceptPending);
+        return server->listen(address, port);
+    }
+
+    // Encode the state once and send the same frame to every subscriber
+    void broadcastState() {
+        channel->stateWakePending.store(false);
+        if (subscribers.isEmpty()) return;
+
+        QByteArray frame = webSocketFrame(0x1, stateJson(channel->readState()));
+        const QList<QTcpSocket *> targets = subscribers;
+        for (QTcpSocket *socket : targets) {
+            if (socket->bytesToWrite() > MaxBacklogBytes) {
+                socket->abort();
+                continue;
+            }
+            socket->write(frame);
+        }
+    }
+
+private:
+    struct Client {
+        QByteArray buffer;
+        bool webSocket = false;
+    };
+
+    ControlServer *owner;
+    ControlChannel *channel;
+    QTcpServer *server = nullptr;
+    QHash<QTcpSocket *, Client> clients;
+    QList<QTcpSocket *> subscribers;
+
+    void acceptPending() {
+        while (server->hasPendingConnections()) {
+            QTcpSocket *socket = server->nextPendingConnection();
+            clients.insert(socket, Client());
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                clients.remove(socket);
+                subscribers.removeOne(socket);
+                socket->deleteLater();
+            });
+        }
+    }
+
+    void onReadyRead(QTcpSocket *socket) {
+        if (!clients.contains(socket)) return;
+        Client &client = clients[socket];
+        client.buffer.append(socket->readAll());
+        if (client.webSocket) {
+            readFrames(socket, client);
+        } else {
+            readRequest(socket, client);
+        }
+    }
+
+    void readRequest(QTcpSocket *socket, Client &client) {
+        qsizetype end = client.buffer.indexOf("\r\n\r\n");
+        if (end < 0) {
+            if (client.buffer.size() > MaxRequestBytes) socket->abort();
+            return;
+        }
+
+        QList<QByteArray> lines = client.buffer.left(end).split('\n');
+        // A client may send its first WebSocket frame along with the handshake
+        client.buffer.remove(0, end + 4);
+        QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+        QByteArray method = requestLine.value(0);
+        QUrl url(QString::fromLatin1(requestLine.value(1)));
+
+        QHash<QByteArray, QByteArray> headers;
+        for (int i = 1; i < lines.size(); ++i) {
+            qsizetype colon = lines[i].indexOf(':');
+            if (colon > 0) {
+                headers.insert(lines[i].left(colon).trimmed().toLower(),
+                               lines[i].mid(colon + 1).trimmed());
+            }
+        }
+
+        QString path = url.path();
+        if (path == "/events" && headers.value("upgrade").toLower() == "websocket") {
+            acceptWebSocket(socket, client, headers.value("sec-websocket-key"));
+            if (client.webSocket) readFrames(socket, client);
+            return;
+        }
+
+        if (path == "/status") {
+            reply(socket, method == "GET"
+                              ? httpResponse(200, "OK", stateJson(channel->readState()))
+                              : httpResponse(405, "Method Not Allowed", "{}"));
+            return;
+        }
+
+        ControlServer::Request request;
+        if (path == "/start") {
+            request.command = ControlServer::Command::Start;
+        } else if (path == "/pause") {
+            request.command = ControlServer::Command::Pause;
+        } else if (path == "/toggle") {
+            request.command = ControlServer::Command::Toggle;
+        } else if (path == "/reset") {
+            request.command = ControlServer::Command::Reset;
+        } else if (path == "/adjust" || path == "/seek") {
+            bool ok = false;
+            request.command = path == "/adjust" ? ControlServer::Command::Adjust
+                                                : ControlServer::Command::Seek;
+            request.ms = QUrlQuery(url).queryItemValue("ms").toLongLong(&ok);
+            if (!ok) {
+                reply(socket, httpResponse(400, "Bad Request", "{\"error\":\"needs ?ms=\"}"));
+                return;
+            }
+        } else {
+            reply(socket, httpResponse(404, "Not Found", "{}"));
+            return;
+        }
+
+        if (method != "POST") {
+            reply(socket, httpResponse(405, "Method Not Allowed", "{}"));
+        } else if (!channel->requests.push(request)) {
+            reply(socket, httpResponse(503, "Service Unavailable", "{\"error\":\"busy\"}"));
+        } else {
+            if (!channel->requestWakePending.exchange(true)) emit owner->requestsPending();
+            reply(socket, httpResponse(202, "Accepted", "{\"queued\":true}"));
+        }
+    }
+
+    void reply(QTcpSocket *socket, const QByteArray &response) {
+        socket->write(response);
+        socket->disconnectFromHost();
+    }
+
+    void acceptWebSocket(QTcpSocket *socket, Client &client, const QByteArray &key) {
+        if (key.isEmpty()) {
+            reply(socket, httpResponse(400, "Bad Request", "{}"));
+            return;
+        }
+        QByteArray accept = QCryptographicHash::hash(key + WebSocketGuid,
+                                                     QCryptographicHash::Sha1).toBase64();
+        socket->write("HTTP/1.1 101 Switching Protocols\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+        client.webSocket = true;
+        subscribers.append(socket);
+        // Start every subscriber off with the current state
+        socket->write(webSocketFrame(0x1, stateJson(channel->readState())));
+    }
+
+    // Subscribers only listen; of their frames only ping and close matter
+    void readFrames(QTcpSocket *socket, Client &client) {
+        while (client.buffer.size() >= 2) {
+            const uchar *data = reinterpret_cast<const uchar *>(client.buffer.constData());
+            quint8 opcode = data[0] & 0x0f;
+            bool masked = data[1] & 0x80;
+            qint64 length = data[1] & 0x7f;
+            int offset = 2;
+            if (length == 126) {
+                if (client.buffer.size() < 4) return;
+                length = (qint64(data[2]) << 8) | data[3];
+                offset = 4;
+            } else if (length == 127) {
+                socket->abort(); // Nothing a status screen sends is that large
+                return;
+            }
+            if (length > MaxRequestBytes) {
+                socket->abort();
+                return;
+            }
+            int headerSize = offset + (masked ? 4 : 0);
+            if (client.buffer.size() < headerSize + length) return;
+
+            QByteArray payload = client.buffer.mid(headerSize, length);
+            if (masked) {
+                for (qsizetype i = 0; i < payload.size(); ++i) {
+                    payload[i] = char(payload[i] ^ data[offset + (i % 4)]);
+                }
+            }
+            client.buffer.remove(0, headerSize + length);
+
+            if (opcode == 0x8) {
+                socket->write(webSocketFrame(0x8, payload.left(2)));
+                socket->disconnectFromHost();
+                return;
+            }
+            if (opcode == 0x9) socket->write(webSocketFrame(0xA, payload));
+        }
+    }
+};
+
+ControlServer::ControlServer(const QHostAddress &address, quint16 port, QObject *parent)
+    : QObject(parent), address(address), port(port), channel(new ControlChannel) {}
+
+ControlServer::~ControlServer() {
+    if (!thread) return;
+    // The worker and its sockets are deleted on their own thread as it finishes
+    thread->quit();
+    thread->wait();
+}
+
+bool ControlServer::start() {
+    thread = new QThread(this);
+    thread->setObjectName("ControlServer");
+    worker = new ControlWorker(this, channel.get());
+    worker->moveToThread(thread);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread->start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(worker, [this, &listening]() {
+        listening = worker->listen(address, port);
+    }, Qt::BlockingQueuedConnection);
+    return listening;
+}
+
+bool ControlServer::takeRequest(Request *request) {
+    if (channel->requests.pop(request)) return true;
+    channel->requestWakePending.store(false);
+    // A push that raced with the store above would otherwise wait for the next one
+    return channel->requests.pop(request);
+}
+
+void ControlServer::publish(const State &state) {
+    channel->writeState(state);
+    if (!worker || channel->stateWakePending.exchange(true)) return;
+    // At most one broadcast is queued however fast the state changes
+    ControlWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target]() { target->broadcastState(); }, Qt::QueuedConnection);
+}
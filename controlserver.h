@@ -0,0 +1,81 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <memory>
+
+#include "timeformat.h"
+
+class QThread;
+class ControlWorker;
+struct ControlChannel;
+
+// Remote control for one timer over plain HTTP, plus a WebSocket stream
+// of its state for any number of status screens:
+//
+//   POST /start  /pause  /toggle  /reset   queue a command (202, or 503 when flooded)
+//   POST /adjust?ms=-30000                 add or take away time, down to the limit
+//   POST /seek?ms=300000                   jump to a remaining time, likewise
+//   GET  /status                           current state as JSON
+//   GET  /events   (WebSocket upgrade)     the same JSON, pushed on every change
+//
+// Sockets, parsing and the fan-out to subscribers all live on the server's
+// own thread. The GUI thread only pops commands from a lock-free queue and
+// writes state snapshots into a seqlock, so no amount of network traffic
+// can hold up a tick or a cue. A change of time that reaches zero or the
+// limit shows in the state it publishes at once, not on the next tick.
+class ControlServer : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Command : quint8 { Start, Pause, Toggle, Reset, Adjust, Seek };
+
+    struct Request {
+        Command command = Command::Toggle;
+        qint64 ms = 0; // Adjust: the change; Seek: the new remaining time
+    };
+
+    struct State {
+        bool running = false;
+        bool paused = false;
+        bool limitReached = false;
+        qint64 remainingMs = 0; // At the moment publish() is called
+        qint64 startMs = 0;
+        qint64 limitMs = 0;
+        // How the display writes the time, for the "text" field
+        TimeLayout layout = TimeLayout::MinutesSeconds;
+        OvertimeSign overtime = OvertimeSign::Minus;
+    };
+
+    ControlServer(const QHostAddress &address, quint16 port, QObject *parent = nullptr);
+    ~ControlServer() override;
+
+    // Starts the server thread and opens the port; false if it could not
+    // be opened.
+    bool start();
+
+    // GUI thread: next queued command, if any. Call until it returns false
+    // whenever requestsPending() arrives.
+    bool takeRequest(Request *request);
+    // GUI thread: make state the one reported to clients and push it out
+    void publish(const State &state);
+
+    // Commands that arrive while this many are still queued are refused
+    static constexpr int MaxQueuedRequests = 256;
+
+signals:
+    // Emitted once per burst of new commands (queued to the GUI thread)
+    void requestsPending();
+
+private:
+    QHostAddress address;
+    quint16 port;
+    std::unique_ptr<ControlChannel> channel;
+    QThread *thread = nullptr;
+    ControlWorker *worker = nullptr;
+
+    friend class ControlWorker;
+};
+
+#endif // CONTROLSERVER_H
@@ -0,0 +1,242 @@
+// QtTest benchmarks for the per-tick and per-resize hot paths.
+//
+//   countdown_bench                      all benchmarks, plain text
+//   countdown_bench -o bench.csv,csv     machine-readable, as used by CI
+//
+// Everything that can be is driven by a ManualClock, so results depend on
+// the code and the machine, not on when the run happened. A few plain
+// checks of the cue thread and the engine run alongside; they add no rows
+// to the CSV.
+
+#include <QApplication>
+#include <QLabel>
+#include <QMediaDevices>
+#include <QTest>
+#include <memory>
+
+#include "audiocuecache.h"
+#include "countdownclock.h"
+#include "cuethread.h"
+#include "fontsizeresolver.h"
+#include "timeformat.h"
+#include "timerengine.h"
+
+class CountdownBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    // --- updateDisplay(): text formatting ---
+    void formatCountdown_data() {
+        QTest::addColumn<qint64>("ms");
+        QTest::newRow("positive") << qint64(39 * 60000 + 59000);
+        QTest::newRow("negative") << qint64(-(14 * 60000 + 1000));
+    }
+
+    void formatCountdown() {
+        QFETCH(qint64, ms);
+        QString text;
+        QBENCHMARK {
+            text = ::formatCountdown(ms);
+        }
+        QVERIFY(!text.isEmpty());
+    }
+
+    void formatInto_data() { formatCountdown_data(); }
+
+    void formatInto() {
+        QFETCH(qint64, ms);
+        char16_t buffer[TimeFormat::MaxLength];
+        int length = 0;
+        QBENCHMARK {
+            length = TimeFormat::formatInto(buffer, ms, TimeLayout::MinutesSeconds);
+        }
+        QCOMPARE(length, ms < 0 ? 6 : 5);
+    }
+
+    // What updateDisplay() does per tick: a lookup in the interned table
+    void textTableLookup() {
+        CountdownTextTable table;
+        table.build(40 * 60000, -15 * 60000, TimeLayout::MinutesSeconds);
+        qint64 ms = 40 * 60000;
+        QBENCHMARK {
+            ms = ms > -15 * 60000 ? ms - 1000 : 40 * 60000;
+            table.text(ms);
+        }
+    }
+
+    // The font is sized for every value the range can show: ss.t of a
+    // 40:00 session reads 2400.0 at the start
+    void widestTextCoversRange() {
+        QCOMPARE(widestCountdownText(40 * 60000, -15 * 60000, TimeLayout::SecondsTenths),
+                 QString("-8888.8"));
+        QCOMPARE(widestCountdownText(5 * 60000, -60000, TimeLayout::MinutesSeconds),
+                 QString("-88:88"));
+    }
+
+    // --- updateDisplay(): pushing the result to the widget ---
+    void labelSetText() {
+        QLabel label;
+        label.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&label));
+        const QString texts[2] = { "39:59", "39:58" };
+        int i = 0;
+        QBENCHMARK {
+            label.setText(texts[i++ & 1]);
+        }
+    }
+
+    // The colour swap as the original code did it, for comparison
+    void labelSetStyleSheet() {
+        QLabel label("-00:01");
+        label.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&label));
+        const QString sheets[2] = { "color: black;", "color: red;" };
+        int i = 0;
+        QBENCHMARK {
+            label.setStyleSheet(sheets[i++ & 1]);
+        }
+    }
+
+    // ...and as updateDisplay() does it now
+    void labelSetPalette() {
+        QLabel label("-00:01");
+        label.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&label));
+        QPalette palettes[2] = { label.palette(), label.palette() };
+        palettes[0].setColor(QPalette::WindowText, Qt::black);
+        palettes[1].setColor(QPalette::WindowText, Qt::red);
+        int i = 0;
+        QBENCHMARK {
+            label.setPalette(palettes[i++ & 1]);
+        }
+    }
+
+    // --- resizeEvent(): font size recomputation ---
+    void fontSizeDrag() {
+        // An interactive drag: every call is a new size, mostly new buckets
+        FontSizeResolver resolver(QApplication::font());
+        int step = 0;
+        QBENCHMARK {
+            step = (step + 1) % 2000;
+            resolver.pointSizeFor(QSize(400 + step, 300 + step / 2));
+        }
+    }
+
+    void fontSizeRepeat() {
+        // Toggling between two known sizes (fullscreen and back)
+        FontSizeResolver resolver(QApplication::font());
+        const QSize sizes[2] = { QSize(600, 400), QSize(1920, 1080) };
+        int i = 0;
+        QBENCHMARK {
+            resolver.pointSizeFor(sizes[i++ & 1]);
+        }
+    }
+
+    // --- playCue(): trigger latency of a decoded cue ---
+    void cuePlay() {
+        if (QMediaDevices::defaultAudioOutput().isNull()) {
+            QSKIP("No audio output device");
+        }
+
+        AudioCueCache cues;
+        AudioCueCache::CueId cue = cues.load(QFINDTESTDATA("sound_zero.mp3"));
+        QVERIFY(cue != AudioCueCache::InvalidCue);
+        cues.initialize();
+        QTRY_VERIFY_WITH_TIMEOUT(cues.isReady(cue), 10000);
+
+        QBENCHMARK {
+            cues.play(cue);
+        }
+        cues.stopAll();
+    }
+
+    // --- CueThread: cues falling due together are all reported ---
+    void cueThreadReportsCoincidingCues() {
+        ManualClock clock(1000);
+        CueThread cues(&clock, 1);
+        cues.start();
+
+        QVector<CueThread::Cue> fired;
+        connect(&cues, &CueThread::cueFired, this, [&fired](int slot, CueThread::Report report) {
+            if (slot == 0) fired.append(report.cue);
+        });
+
+        // A warning at 00:00, with nothing loaded: both beep in one pass
+        auto timeline = std::make_shared<CueTimeline>();
+        timeline->add(0, CueThread::Cue::Zero, CueThread::InvalidCue);
+        timeline->add(0, CueThread::Cue::Warning, CueThread::InvalidCue);
+
+        CueThread::Arming arming;
+        arming.timeline = timeline;
+        arming.endAtMs = clock.nowMs();
+        arming.remainingMs = 1;
+        cues.arm(0, arming);
+
+        QTRY_COMPARE(fired.size(), 2);
+        QVERIFY(fired.contains(CueThread::Cue::Zero));
+        QVERIFY(fired.contains(CueThread::Cue::Warning));
+    }
+
+    // --- TimerEngine: a change of time settles zero and the limit at once ---
+    void engineAdjustReachesLimit() {
+        TimerEngine engine;
+        engine.setClock(std::make_unique<ManualClock>());
+        TimerEngine::TimerId id = engine.addTimer(60 * 1000, -60 * 1000);
+        engine.start(id);
+
+        int zeros = 0;
+        int limits = 0;
+        connect(&engine, &TimerEngine::zeroReached, this, [&zeros]() { zeros++; });
+        connect(&engine, &TimerEngine::limitReached, this, [&limits]() { limits++; });
+        engine.adjust(id, -10 * 60 * 1000);
+
+        QCOMPARE(zeros, 1);
+        QCOMPARE(limits, 1);
+        QCOMPARE(engine.remainingMs(id), qint64(-60 * 1000));
+        QVERIFY(!engine.isRunning(id));
+    }
+
+    // --- TimerEngine: one advance over many running timers ---
+    // Timers advanced per second = timers / (time per iteration)
+    void engineAdvance_data() {
+        QTest::addColumn<int>("timers");
+        QTest::newRow("1") << 1;
+        QTest::newRow("100") << 100;
+        QTest::newRow("10000") << 10000;
+    }
+
+    void engineAdvance() {
+        QFETCH(int, timers);
+
+        // QtTest calls this again for every calibration pass; the timers
+        // are set up once per row and only the advance is timed
+        if (!advanceEngine || advanceEngine->timerCount() != timers) {
+            advanceEngine = std::make_unique<TimerEngine>();
+            auto clock = std::make_unique<ManualClock>();
+            advanceClock = clock.get();
+            advanceEngine->setClock(std::move(clock));
+
+            // Long enough that no timer reaches its limit during the run
+            const qint64 day = 24 * 3600 * 1000;
+            for (int i = 0; i < timers; ++i) {
+                advanceEngine->start(advanceEngine->addTimer(day, -day));
+            }
+        }
+
+        TimerEngine &engine = *advanceEngine;
+        ManualClock *manual = advanceClock;
+        QBENCHMARK {
+            manual->advance(1);
+            engine.advance(manual->nowMs());
+        }
+        QVERIFY(engine.isRunning(0));
+    }
+
+private:
+    std::unique_ptr<TimerEngine> advanceEngine;
+    ManualClock *advanceClock = nullptr; // Owned by advanceEngine
+};
+
+QTEST_MAIN(CountdownBench)
+
+#include "countdown_bench.moc"
@@ -0,0 +1,81 @@
+#include "countdownclock.h"
+
+#include <QDateTime>
+
+SteadyClock::SteadyClock() {
+    elapsed.start();
+}
+
+qint64 SteadyClock::nowMs() const {
+    return elapsed.elapsed();
+}
+
+qint64 SteadyClock::nowUs() const {
+    return elapsed.nsecsElapsed() / 1000;
+}
+
+qint64 WallClock::nowMs() const {
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+qint64 WallClock::msUntil(const QTime &endTime) {
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime end = now;
+    end.setTime(endTime);
+    if (end <= now) {
+        end = end.addDays(1); // Already past today: means tomorrow
+    }
+    return now.msecsTo(end);
+}
+
+qint64 SyncedClock::nowMs() const {
+    return nowUs() / 1000;
+}
+
+qint64 SyncedClock::nowUs() const {
+    qint64 localUs = local.nowUs();
+    return localUs + offsetAt(localUs);
+}
+
+qint64 SyncedClock::offsetUs() const {
+    return offsetAt(local.nowUs());
+}
+
+qint64 SyncedClock::offsetAt(qint64 localUs) const {
+    qint64 from;
+    qint64 start;
+    qint64 target;
+    quint32 before;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        from = slewFromUs.load(std::memory_order_relaxed);
+        start = slewStartUs.load(std::memory_order_relaxed);
+        target = targetUs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((before & 1) || sequence.load(std::memory_order_relaxed) != before);
+
+    // Covers MaxSlewPpm us of the remaining distance per second of local time
+    qint64 covered = qMax<qint64>(0, localUs - start) * MaxSlewPpm / 1000000;
+    qint64 distance = target - from;
+    if (qAbs(distance) <= covered) return target;
+    return distance > 0 ? from + covered : from - covered;
+}
+
+void SyncedClock::stepTo(qint64 offsetUs) {
+    setSlew(offsetUs, local.nowUs(), offsetUs);
+}
+
+void SyncedClock::slewTo(qint64 offsetUs) {
+    qint64 localUs = local.nowUs();
+    setSlew(offsetAt(localUs), localUs, offsetUs);
+}
+
+void SyncedClock::setSlew(qint64 fromUs, qint64 startUs, qint64 toUs) {
+    quint32 before = sequence.load(std::memory_order_relaxed);
+    sequence.store(before + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slewFromUs.store(fromUs, std::memory_order_relaxed);
+    slewStartUs.store(startUs, std::memory_order_relaxed);
+    targetUs.store(toUs, std::memory_order_relaxed);
+    sequence.store(before + 2, std::memory_order_release);
+}
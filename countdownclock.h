@@ -0,0 +1,87 @@
+#ifndef COUNTDOWNCLOCK_H
+#define COUNTDOWNCLOCK_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <QTime>
+#include <atomic>
+
+// Time source for the countdown arithmetic (targetEndTime, currentMs).
+// All values are milliseconds on the clock's own timeline; only differences
+// between two readings of the same clock are meaningful.
+class CountdownClock {
+public:
+    virtual ~CountdownClock() = default;
+    virtual qint64 nowMs() const = 0;
+    // The same timeline in microseconds, for time sync; backends without
+    // a finer source just scale nowMs()
+    virtual qint64 nowUs() const { return nowMs() * 1000; }
+};
+
+// Default backend: monotonic, never jumps on NTP/DST adjustments.
+class SteadyClock : public CountdownClock {
+public:
+    SteadyClock();
+    qint64 nowMs() const override;
+    qint64 nowUs() const override;
+
+private:
+    QElapsedTimer elapsed;
+};
+
+// Wall-clock backend, for targets expressed as a time of day ("end at 14:30").
+class WallClock : public CountdownClock {
+public:
+    qint64 nowMs() const override;
+
+    // Milliseconds from now until the next occurrence of endTime (local time).
+    static qint64 msUntil(const QTime &endTime);
+};
+
+// The steady clock moved onto another machine's timeline (a publisher's
+// engine clock) by an offset that TimeSyncClient keeps estimating. Changes
+// to the offset are slewed, at most MaxSlewPpm, so the clock never jumps or
+// runs backwards; only stepTo() jumps, and the engine has to be told.
+//
+// Read from any thread (the cue thread uses the engine's clock); the
+// offset is only ever changed from one.
+class SyncedClock : public CountdownClock {
+public:
+    static constexpr qint64 MaxSlewPpm = 500;
+
+    qint64 nowMs() const override;
+    qint64 nowUs() const override;
+
+    // The offset being applied right now
+    qint64 offsetUs() const;
+    // Jump straight to offsetUs
+    void stepTo(qint64 offsetUs);
+    // Move towards offsetUs gradually, starting from the current offset
+    void slewTo(qint64 offsetUs);
+
+private:
+    SteadyClock local;
+    // Seqlock: odd while the three values below are being written
+    mutable std::atomic<quint32> sequence{0};
+    std::atomic<qint64> slewFromUs{0};   // Offset at slewStartUs
+    std::atomic<qint64> slewStartUs{0};  // Local time the slew started
+    std::atomic<qint64> targetUs{0};     // Offset the slew ends at
+
+    qint64 offsetAt(qint64 localUs) const;
+    void setSlew(qint64 fromUs, qint64 startUs, qint64 toUs);
+};
+
+// Manually driven clock for deterministic tests and benchmarks.
+class ManualClock : public CountdownClock {
+public:
+    explicit ManualClock(qint64 startMs = 0) : current(startMs) {}
+
+    qint64 nowMs() const override { return current; }
+    void setNowMs(qint64 ms) { current = ms; }
+    void advance(qint64 ms) { current += ms; }
+
+private:
+    qint64 current;
+};
+
+#endif // COUNTDOWNCLOCK_H
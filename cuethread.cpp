@@ -0,0 +1,299 @@
+#include "cuethread.h"
+
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+
+#include "audiocuecache.h"
+#include "countdownclock.h"
+#include "mailbox.h"
+#include "spscqueue.h"
+#include "timermetrics.h"
+
+struct CueChannel {
+    explicit CueChannel(int slotCount)
+        : slotCount(slotCount),
+          armings(new Mailbox<CueThread::Arming>[slotCount]) {}
+
+    struct SlotReport {
+        int slot = 0;
+        CueThread::Report report;
+    };
+
+    const int slotCount;
+    // GUI thread -> cue thread
+    std::unique_ptr<Mailbox<CueThread::Arming>[]> armings;
+    std::atomic<bool> armWakePending{false};
+    // Cue thread -> GUI thread: every report, not just the latest, since
+    // one pass can fire several cues (a warning at zero, a resume past a few)
+    SpscQueue<SlotReport, 256> reports;
+    std::atomic<bool> reportWakePending{false};
+};
+
+namespace {
+
+// A follower re-anchors its deadlines on every snapshot, so a deadline is
+// taken to be the crossing that already fired if it lands this close to it
+const qint64 SameCrossingMs = 250;
+
+} // namespace
+
+// Lives on the cue thread and owns everything that plays sound. The cache
+// is made here, before the move, but creates no multimedia objects until
+// initialize() arrives on the cue thread.
+class CueWorker : public QObject {
+public:
+    CueWorker(CueThread *owner, CueChannel *channel, const CountdownClock *clock)
+        : owner(owner), channel(channel), clock(clock), slotStates(channel->slotCount) {
+        deadline = new QTimer(this);
+        deadline->setSingleShot(true);
+        deadline->setTimerType(Qt::PreciseTimer);
+        connect(deadline, &QTimer::timeout, this, &CueWorker::service);
+
+        // Reported to the GUI thread in CueThread ids, with how many cues
+        // the settling covers so it can tell a stale report
+        cache = new AudioCueCache(this);
+        connect(cache, &AudioCueCache::allCuesSettled, this, [this]() {
+            CueThread *target = this->owner;
+            int count = int(cacheIds.size());
+            QMetaObject::invokeMethod(target, [target, count]() { target->cachesSettled(count); },
+                                      Qt::QueuedConnection);
+        });
+        connect(cache, &AudioCueCache::cueFailed, this,
+                [this](AudioCueCache::CueId cacheId, const QString &error) {
+            CueThread *target = this->owner;
+            CueThread::CueId id = CueThread::CueId(cacheIds.indexOf(cacheId));
+            QMetaObject::invokeMethod(target, [target, id, error]() { target->decodeFailed(id, error); },
+                                      Qt::QueuedConnection);
+        });
+    }
+
+    AudioCueCache *audio() { return cache; }
+    void setMetrics(TimerMetrics *newMetrics) { metrics = newMetrics; }
+
+    void addCue(const QUrl &source) {
+        cacheIds.append(cache->load(source));
+    }
+
+    void drainArmings() {
+        channel->armWakePending.store(false);
+        qint64 now = clock->nowMs();
+        for (int i = 0; i < slotStates.size(); ++i) {
+            CueThread::Arming next;
+            if (!channel->armings[i].take(&next)) continue;
+
+            // Whatever came due before the change arrived still plays
+            fireDue(i, now);
+
+            Slot &slot = slotStates[i];
+            // Another segment's timeline shares no crossings with this one
+            if (next.timeline != slot.arming.timeline) slot.firedIndex = -1;
+            slot.arming = next;
+            slot.cursor = 0;
+            if (!isArmed(slot)) continue;
+            slot.cursor = next.timeline->seek(next.remainingMs);
+            if (slot.cursor == slot.firedIndex
+                && isSameCrossing(dueAt(slot, slot.cursor), slot.firedAtMs)) {
+                slot.cursor++;
+            }
+        }
+        service();
+    }
+
+    void fireNow(int slot, CueThread::Cue cue, CueThread::CueId id) {
+        qint64 now = clock->nowMs();
+        fire(slot, cue, id, now, now);
+    }
+
+private:
+    struct Slot {
+        CueThread::Arming arming;
+        int cursor = 0;        // Next timeline entry to play
+        int firedIndex = -1;   // The entry played last, and when it was due
+        qint64 firedAtMs = CueThread::NotArmed;
+    };
+
+    CueThread *owner;
+    CueChannel *channel;
+    const CountdownClock *clock;
+    TimerMetrics *metrics = nullptr;
+    // One cache for every slot, so a file is decoded once however many
+    // windows play it; its voices are tagged with the slot
+    AudioCueCache *cache;
+    QVector<AudioCueCache::CueId> cacheIds; // Indexed by CueThread::CueId
+    QVector<Slot> slotStates;
+    QTimer *deadline;
+
+    static bool isArmed(const Slot &slot) {
+        return slot.arming.timeline && slot.arming.endAtMs != CueThread::NotArmed;
+    }
+
+    static qint64 dueAt(const Slot &slot, int index) {
+        return slot.arming.endAtMs - slot.arming.timeline->at(index).atMs;
+    }
+
+    static bool isSameCrossing(qint64 atMs, qint64 firedAtMs) {
+        return firedAtMs != CueThread::NotArmed && qAbs(atMs - firedAtMs) < SameCrossingMs;
+    }
+
+    // Fire everything that is due, then sleep until the next deadline.
+    // Only the entry under each slot's cursor is ever looked at.
+    void service() {
+        qint64 now = clock->nowMs();
+        qint64 next = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < slotStates.size(); ++i) {
+            fireDue(i, now);
+            const Slot &slot = slotStates[i];
+            if (isArmed(slot) && slot.cursor < slot.arming.timeline->size()) {
+                next = qMin(next, dueAt(slot, slot.cursor));
+            }
+        }
+
+        if (next == std::numeric_limits<qint64>::max()) {
+            deadline->stop();
+            return;
+        }
+        // A timer that wakes a little early just goes round again
+        deadline->start(int(qBound<qint64>(1, next - now, std::numeric_limits<int>::max())));
+    }
+
+    void fireDue(int index, qint64 now) {
+        Slot &slot = slotStates[index];
+        if (!isArmed(slot)) return;
+        const CueTimeline &timeline = *slot.arming.timeline;
+        while (slot.cursor < timeline.size() && dueAt(slot, slot.cursor) <= now) {
+            const CueTimeline::Entry &entry = timeline.at(slot.cursor);
+            qint64 dueAtMs = dueAt(slot, slot.cursor);
+            fire(index, entry.kind, entry.cue, dueAtMs, now);
+            slot.firedIndex = slot.cursor;
+            slot.firedAtMs = dueAtMs;
+            slot.cursor++;
+        }
+    }
+
+    void fire(int index, CueThread::Cue cue, CueThread::CueId id, qint64 dueAtMs, qint64 now) {
+        AudioCueCache::CueId cacheId = cacheIds.value(id, AudioCueCache::InvalidCue);
+
+        CueThread::Report report;
+        report.cue = cue;
+        report.played = cache->play(cacheId, index);
+        report.latenessUs = (now - dueAtMs) * 1000;
+        if (metrics) {
+            // Up to the sound being queued on the device, play() included
+            metrics->observe(TimerMetrics::CueLatency, clock->nowUs() - dueAtMs * 1000);
+        }
+        // Only a GUI thread stuck for hundreds of cues fills it; those are dropped
+        channel->reports.push({ index, report });
+
+        if (!channel->reportWakePending.exchange(true)) {
+            CueThread *target = owner;
+            QMetaObject::invokeMethod(target, [target]() { target->deliverReports(); },
+                                      Qt::QueuedConnection);
+        }
+    }
+};
+
+CueThread::CueThread(const CountdownClock *clock, int slotCount, QObject *parent)
+    : QObject(parent), channel(new CueChannel(slotCount)), slotInitialized(slotCount, false) {
+    thread = new QThread(this);
+    thread->setObjectName("CueThread");
+    worker = new CueWorker(this, channel.get(), clock);
+
+    // The cache is a child of the worker and moves with it
+    worker->moveToThread(thread);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+}
+
+CueThread::~CueThread() {
+    thread->quit();
+    thread->wait();
+}
+
+void CueThread::start() {
+    thread->start(QThread::TimeCriticalPriority);
+}
+
+void CueThread::setMetrics(TimerMetrics *metrics) {
+    worker->setMetrics(metrics);
+}
+
+CueThread::CueId CueThread::load(int slot, const QString &fileName, QString *error) {
+    QUrl source = AudioCueCache::resolve(fileName, error);
+    if (source.isEmpty()) return InvalidCue;
+
+    // Keyed by the resolved URL, so two names for one file share a decode
+    QString key = source.toString();
+    CueId id = cueBySource.value(key, InvalidCue);
+    if (id == InvalidCue) {
+        id = CueId(cueSlots.size());
+        cueBySource.insert(key, id);
+        cueSlots.append(QList<int>());
+        settled = false;
+        // Queued calls arrive in order, so the worker's list lines up with id
+        CueWorker *target = worker;
+        QMetaObject::invokeMethod(target, [target, source]() { target->addCue(source); },
+                                  Qt::QueuedConnection);
+    }
+    if (!cueSlots[id].contains(slot)) {
+        cueSlots[id].append(slot);
+        // Another window's load already found it undecodable
+        if (cueErrors.contains(id)) emit cueFailed(slot, cueErrors.value(id));
+    }
+    return id;
+}
+
+void CueThread::initialize(int slot) {
+    slotInitialized[slot] = true;
+    // Another window brought the shared cache up, and everything loaded
+    // since has settled too
+    if (settled) {
+        emit cuesSettled(slot);
+        return;
+    }
+    CueWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target]() { target->audio()->initialize(); },
+                              Qt::QueuedConnection);
+}
+
+void CueThread::stopAll(int slot) {
+    CueWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target, slot]() { target->audio()->stop(slot); },
+                              Qt::QueuedConnection);
+}
+
+void CueThread::cachesSettled(int cueCount) {
+    // Cues loaded after the cache reported are still decoding
+    if (cueCount < cueSlots.size()) return;
+    settled = true;
+    for (int slot = 0; slot < slotInitialized.size(); ++slot) {
+        if (slotInitialized[slot]) emit cuesSettled(slot);
+    }
+}
+
+void CueThread::decodeFailed(CueId id, const QString &error) {
+    if (id < 0 || id >= cueSlots.size()) return;
+    cueErrors.insert(id, error);
+    for (int slot : cueSlots[id]) emit cueFailed(slot, error);
+}
+
+void CueThread::arm(int slot, const Arming &arming) {
+    channel->armings[slot].post(arming);
+    if (channel->armWakePending.exchange(true)) return;
+    // One wake however many slotStates change before the cue thread gets to it
+    CueWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target]() { target->drainArmings(); },
+                              Qt::QueuedConnection);
+}
+
+void CueThread::play(int slot, Cue cue, CueId id) {
+    CueWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target, slot, cue, id]() { target->fireNow(slot, cue, id); },
+                              Qt::QueuedConnection);
+}
+
+void CueThread::deliverReports() {
+    channel->reportWakePending.store(false);
+    // A report pushed after the store above queues another call
+    CueChannel::SlotReport next;
+    while (channel->reports.pop(&next)) emit cueFired(next.slot, next.report);
+}
@@ -0,0 +1,113 @@
+#ifndef CUETHREAD_H
+#define CUETHREAD_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <limits>
+#include <memory>
+
+#include "cuetimeline.h"
+
+class CountdownClock;
+class CueWorker;
+class QThread;
+class TimerMetrics;
+struct CueChannel;
+
+// Plays the zero and limit cues from a dedicated high-priority thread, so
+// they sound on time even while the GUI thread is stuck in a slow paint, a
+// window drag or a modal dialog.
+//
+// The GUI thread hands over each timer's cue timeline and end time through
+// a single-slot mailbox whenever its state changes; the cue thread seeks
+// its cursor on that timeline, keeps its own precise timer for the next
+// deadline and triggers the cue there, then steps to the one after without
+// going back through the GUI thread. What it played, and how late, comes
+// back through a lock-free queue, one report per cue fired.
+//
+// Every slot (one per TimerEngine timer) shares one AudioCueCache on the
+// cue thread, keyed by resolved URL, so --timers N decodes each file once.
+// Voices are tagged with their slot: stopping one window's cues leaves the
+// others playing.
+//
+// Qt Multimedia objects are not thread-safe, but they need not be on the
+// GUI thread either: each must be created, used and destroyed on one
+// thread that runs an event loop. The cache only touches the backend from
+// initialize() on, which runs on the cue thread, so every sink, decoder
+// and device query lives there and nothing crosses threads but plain data.
+class CueThread : public QObject {
+    Q_OBJECT
+
+public:
+    using CueId = int;
+    static constexpr CueId InvalidCue = -1;
+    static constexpr qint64 NotArmed = std::numeric_limits<qint64>::min();
+
+    using Cue = CueTimeline::Kind;
+
+    // Each cue is due at endAtMs - atMs on the engine's clock
+    struct Arming {
+        std::shared_ptr<const CueTimeline> timeline; // Null: nothing to play
+        qint64 endAtMs = NotArmed;  // targetEndTime; NotArmed unless running
+        qint64 remainingMs = 0;     // At the change; the cursor seeks from here
+    };
+
+    struct Report {
+        Cue cue = Cue::Zero;
+        bool played = false;  // False if the cue was missing or not decoded
+        qint64 latenessUs = 0; // Behind its deadline (ms resolution)
+    };
+
+    // clock must be the engine's, so deadlines can be taken straight from
+    // targetEndTime; it is only read, from both threads.
+    CueThread(const CountdownClock *clock, int slotCount, QObject *parent = nullptr);
+    ~CueThread() override;
+
+    void start();
+    // Record cue latency in metrics, from the cue thread; before start()
+    void setMetrics(TimerMetrics *metrics);
+
+    // Same contract as AudioCueCache, per slot; ids are shared by every
+    // slot. The file is checked here, once; the cue thread only ever sees
+    // the resolved URL, so neither decoding nor triggering touches the
+    // file system again.
+    CueId load(int slot, const QString &fileName, QString *error = nullptr);
+    void initialize(int slot);
+    void stopAll(int slot);
+
+    // Replace slot's deadlines. A deadline that is already due when this
+    // arrives still fires, so a change racing the cue never swallows it;
+    // so does any cue between remainingMs and the time it arrives.
+    void arm(int slot, const Arming &arming);
+    // Play one cue now, off any timeline: a change of time that landed on
+    // zero or the limit, which no deadline was waiting for
+    void play(int slot, Cue cue, CueId id);
+
+signals:
+    // Every cue loaded so far, into slot or any other, has finished
+    // decoding (or failed); only for slots that have been initialized
+    void cuesSettled(int slot);
+    void cueFailed(int slot, const QString &error);
+    void cueFired(int slot, CueThread::Report report);
+
+private:
+    std::unique_ptr<CueChannel> channel;
+    QThread *thread;
+    CueWorker *worker;
+    QHash<QString, CueId> cueBySource;
+    QVector<QList<int>> cueSlots;    // Indexed by CueId: the slots that loaded it
+    QHash<CueId, QString> cueErrors; // Cues that failed to decode
+    QVector<bool> slotInitialized;
+    bool settled = false;            // Every cue so far has finished decoding
+
+    void deliverReports();
+    void cachesSettled(int cueCount);
+    void decodeFailed(CueId id, const QString &error);
+
+    friend class CueWorker;
+};
+
+#endif // CUETHREAD_H
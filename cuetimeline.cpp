@@ -0,0 +1,27 @@
+#include "cuetimeline.h"
+
+#include <algorithm>
+
+void CueTimeline::add(qint64 atMs, Kind kind, CueId cue) {
+    Entry entry;
+    entry.atMs = atMs;
+    entry.kind = kind;
+    entry.cue = cue;
+    // Equal times keep the order they were added in
+    auto position = std::upper_bound(entries.begin(), entries.end(), atMs,
+                                     [](qint64 value, const Entry &other) { return value > other.atMs; });
+    entries.insert(position, entry);
+}
+
+int CueTimeline::seek(qint64 remainingMs) const {
+    auto next = std::partition_point(entries.begin(), entries.end(),
+                                     [remainingMs](const Entry &entry) { return entry.atMs >= remainingMs; });
+    return int(next - entries.begin());
+}
+
+int CueTimeline::indexOf(Kind kind) const {
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.at(i).kind == kind) return i;
+    }
+    return -1;
+}
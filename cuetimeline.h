@@ -0,0 +1,44 @@
+#ifndef CUETIMELINE_H
+#define CUETIMELINE_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Every cue one segment can play, sorted by when the countdown reaches it
+// (largest remaining time first, as the countdown runs). Built once per
+// segment and then only read, so it can be shared with the cue thread.
+//
+// Whoever plays the cues keeps a cursor into it: seek() puts the cursor
+// on the next cue for a given remaining time by binary search (on start,
+// pause, resume or any change of time), and from there each fired cue is
+// only a step to the next entry.
+class CueTimeline {
+public:
+    using CueId = int;
+
+    enum class Kind : quint8 { Zero, Limit, Warning };
+
+    struct Entry {
+        qint64 atMs = 0;  // Remaining time at which it plays; negative past zero
+        Kind kind = Kind::Warning;
+        CueId cue = -1;   // The player's id; invalid ones fall back to a beep
+    };
+
+    void add(qint64 atMs, Kind kind, CueId cue);
+
+    int size() const { return int(entries.size()); }
+    bool isEmpty() const { return entries.isEmpty(); }
+    const Entry &at(int index) const { return entries.at(index); }
+
+    // Index of the first cue still ahead with remainingMs on the clock,
+    // i.e. the first one at less than remainingMs; size() if none is
+    int seek(qint64 remainingMs) const;
+    // Index of the first entry of kind, or -1; for a change of time that
+    // lands on zero or the limit, which no cursor walks up to
+    int indexOf(Kind kind) const;
+
+private:
+    QVector<Entry> entries;
+};
+
+#endif // CUETIMELINE_H
@@ -0,0 +1,33 @@
+#include "fontsizeresolver.h"
+
+#include <QFontMetricsF>
+#include <algorithm>
+
+FontSizeResolver::FontSizeResolver(const QFont &baseFont, const QString &widestText) {
+    // Measure at a large reference size to keep rounding error negligible
+    const int referencePointSize = 100;
+    QFont font = baseFont;
+    font.setPointSize(referencePointSize);
+
+    qreal advance = QFontMetricsF(font).horizontalAdvance(widestText);
+    if (advance > 0) {
+        advancePerPoint = advance / referencePointSize;
+    }
+}
+
+int FontSizeResolver::pointSizeFor(const QSize &windowSize) {
+    int bucketW = windowSize.width() / BucketPx;
+    int bucketH = windowSize.height() / BucketPx;
+    quint32 key = (quint32(bucketW) << 16) | (quint32(bucketH) & 0xffff);
+
+    int cached = sizeByBucket.value(key, 0);
+    if (cached > 0) return cached;
+
+    // Size for the bucket's lower edge so the text always fits inside it
+    int sizeByHeight = int(bucketH * BucketPx * HeightFill);
+    int sizeByWidth = int(bucketW * BucketPx * WidthFill / advancePerPoint);
+    int pointSize = std::max(std::min(sizeByHeight, sizeByWidth), MinPointSize);
+
+    sizeByBucket.insert(key, pointSize);
+    return pointSize;
+}
@@ -0,0 +1,31 @@
+#ifndef FONTSIZERESOLVER_H
+#define FONTSIZERESOLVER_H
+
+#include <QFont>
+#include <QHash>
+#include <QSize>
+#include <QString>
+
+// Picks the display point size for a window size without re-measuring.
+// The widest text the timer can show is measured once with QFontMetrics;
+// glyph advances scale linearly with point size, so every later lookup is
+// arithmetic, cached per window-size bucket.
+class FontSizeResolver {
+public:
+    explicit FontSizeResolver(const QFont &baseFont = QFont(),
+                              const QString &widestText = QStringLiteral("-88:88"));
+
+    int pointSizeFor(const QSize &windowSize);
+
+    static constexpr int MinPointSize = 20;
+
+private:
+    static constexpr int BucketPx = 8;       // Window sizes are grouped into 8 px steps
+    static constexpr qreal HeightFill = 0.50; // Text takes about half the window height
+    static constexpr qreal WidthFill = 0.90;  // ...and at most 90% of its width
+
+    qreal advancePerPoint = 1.0;
+    QHash<quint32, int> sizeByBucket;
+};
+
+#endif // FONTSIZERESOLVER_H
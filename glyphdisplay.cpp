@@ -0,0 +1,235 @@
+#include "glyphdisplay.h"
+
+#include <QEvent>
+#include <QFontMetricsF>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QVector>
+#include <cmath>
+
+namespace {
+
+const char GlyphChars[] = "0123456789:-.+";
+
+const char *VertexShader =
+    "attribute highp vec2 position;\n"
+    "attribute highp vec2 texCoord;\n"
+    "varying highp vec2 uv;\n"
+    "void main() {\n"
+    "    uv = texCoord;\n"
+    "    gl_Position = vec4(position, 0.0, 1.0);\n"
+    "}\n";
+
+// The atlas stores coverage in alpha; output is premultiplied colour
+const char *FragmentShader =
+    "uniform sampler2D atlas;\n"
+    "uniform mediump vec4 color;\n"
+    "varying highp vec2 uv;\n"
+    "void main() {\n"
+    "    gl_FragColor = color * texture2D(atlas, uv).a;\n"
+    "}\n";
+
+} // namespace
+
+GlyphDisplay::GlyphDisplay(QWidget *parent) : QOpenGLWidget(parent) {
+}
+
+GlyphDisplay::~GlyphDisplay() {
+    // GL resources must be released with the context current
+    makeCurrent();
+    atlas.reset();
+    program.reset();
+    doneCurrent();
+}
+
+void GlyphDisplay::setText(const QString &text) {
+    if (text == currentText) return;
+    currentText = text;
+    update();
+}
+
+bool GlyphDisplay::isSupported() {
+    QOpenGLContext context;
+    if (!context.create()) return false;
+
+    QOffscreenSurface surface;
+    surface.create();
+    if (!context.makeCurrent(&surface)) return false;
+
+    QString renderer = QString::fromLatin1(
+        reinterpret_cast<const char *>(context.functions()->glGetString(GL_RENDERER)));
+    context.doneCurrent();
+
+    static const char *softwareRenderers[] = { "llvmpipe", "softpipe", "Software", "GDI Generic" };
+    for (const char *name : softwareRenderers) {
+        if (renderer.contains(QString::fromLatin1(name), Qt::CaseInsensitive)) return false;
+    }
+    return !renderer.isEmpty();
+}
+
+void GlyphDisplay::initializeGL() {
+    initializeOpenGLFunctions();
+
+    program = std::make_unique<QOpenGLShaderProgram>();
+    program->addShaderFromSourceCode(QOpenGLShader::Vertex, VertexShader);
+    program->addShaderFromSourceCode(QOpenGLShader::Fragment, FragmentShader);
+    program->bindAttributeLocation("position", 0);
+    program->bindAttributeLocation("texCoord", 1);
+    program->link();
+
+    atlasDirty = true;
+}
+
+void GlyphDisplay::changeEvent(QEvent *event) {
+    QOpenGLWidget::changeEvent(event);
+    if (event->type() == QEvent::FontChange) {
+        atlasDirty = true;
+        update();
+    } else if (event->type() == QEvent::PaletteChange) {
+        update();
+    }
+}
+
+int GlyphDisplay::glyphIndex(QChar ch) {
+    char16_t c = ch.unicode();
+    if (c >= u'0' && c <= u'9') return c - u'0';
+    if (c == u':') return 10;
+    if (c == u'-') return 11;
+    if (c == u'.') return 12;
+    if (c == u'+') return 13;
+    return -1;
+}
+
+void GlyphDisplay::rebuildAtlas() {
+    qreal dpr = devicePixelRatioF();
+    QFontMetricsF metrics(font());
+    lineHeight = metrics.height();
+    ascent = metrics.ascent();
+
+    // A grid of equal cells, each as wide as the widest advance plus a
+    // 1 px gutter each side; square-ish, so far from any texture size limit
+    qreal cellW = 0;
+    for (int i = 0; i < GlyphCount; ++i) {
+        glyphs[i].advance = metrics.horizontalAdvance(QChar(GlyphChars[i]));
+        cellW = qMax(cellW, std::ceil(glyphs[i].advance) + 2);
+    }
+    qreal cellH = std::ceil(lineHeight) + 2;
+    const int rows = (GlyphCount + AtlasColumns - 1) / AtlasColumns;
+
+    // A display too big even for the grid is rasterised at a lower scale;
+    // the quads stay the same size and the texture is magnified
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    qreal scale = dpr;
+    qreal largest = qMax(AtlasColumns * cellW, rows * cellH);
+    if (maxTextureSize > 0 && largest * scale > maxTextureSize) {
+        scale = maxTextureSize / largest;
+    }
+
+    int atlasW = int(std::ceil(AtlasColumns * cellW * scale));
+    int atlasH = int(std::ceil(rows * cellH * scale));
+    if (maxTextureSize > 0) {
+        atlasW = qMin(atlasW, int(maxTextureSize));
+        atlasH = qMin(atlasH, int(maxTextureSize));
+    }
+    QImage image(qMax(atlasW, 1), qMax(atlasH, 1), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    image.setDevicePixelRatio(scale);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font());
+    painter.setPen(Qt::white);
+
+    for (int i = 0; i < GlyphCount; ++i) {
+        qreal x = (i % AtlasColumns) * cellW + 1;
+        qreal y = (i / AtlasColumns) * cellH + 1;
+        painter.drawText(QPointF(x, y + ascent), QString(QChar(GlyphChars[i])));
+        glyphs[i].uv = QRectF(x * scale / image.width(), y * scale / image.height(),
+                              glyphs[i].advance * scale / image.width(),
+                              lineHeight * scale / image.height());
+    }
+    painter.end();
+
+    atlas = std::make_unique<QOpenGLTexture>(image, QOpenGLTexture::DontGenerateMipMaps);
+    atlas->setMinificationFilter(QOpenGLTexture::Linear);
+    atlas->setMagnificationFilter(QOpenGLTexture::Linear);
+    atlas->setWrapMode(QOpenGLTexture::ClampToEdge);
+
+    atlasDpr = dpr;
+    atlasDirty = false;
+}
+
+void GlyphDisplay::paintGL() {
+    QColor background = palette().color(QPalette::Window);
+    glClearColor(background.redF(), background.greenF(), background.blueF(), 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (currentText.isEmpty() || !program) return;
+    if (atlasDirty || atlasDpr != devicePixelRatioF()) rebuildAtlas();
+
+    // Lay the string out centred, in logical pixels
+    qreal textWidth = 0;
+    for (QChar ch : currentText) {
+        int index = glyphIndex(ch);
+        if (index >= 0) textWidth += glyphs[index].advance;
+    }
+    qreal x = (width() - textWidth) / 2.0;
+    qreal top = (height() - lineHeight) / 2.0;
+
+    // Two triangles per glyph: position (NDC) + texture coordinate. The
+    // buffers are members, so after the first frame this allocates nothing.
+    positions.resize(currentText.size() * 12);
+    texCoords.resize(currentText.size() * 12);
+    GLfloat *position = positions.data();
+    GLfloat *texCoord = texCoords.data();
+
+    auto toNdcX = [this](qreal px) { return GLfloat(px / width() * 2.0 - 1.0); };
+    auto toNdcY = [this](qreal py) { return GLfloat(1.0 - py / height() * 2.0); };
+
+    for (QChar ch : currentText) {
+        int index = glyphIndex(ch);
+        if (index < 0) continue;
+        const Glyph &glyph = glyphs[index];
+
+        GLfloat x0 = toNdcX(x), x1 = toNdcX(x + glyph.advance);
+        GLfloat y0 = toNdcY(top), y1 = toNdcY(top + lineHeight);
+        GLfloat u0 = GLfloat(glyph.uv.left()), u1 = GLfloat(glyph.uv.right());
+        GLfloat v0 = GLfloat(glyph.uv.top()), v1 = GLfloat(glyph.uv.bottom());
+
+        const GLfloat quadPos[] = { x0, y0, x1, y0, x0, y1, x1, y0, x1, y1, x0, y1 };
+        const GLfloat quadUv[] = { u0, v0, u1, v0, u0, v1, u1, v0, u1, v1, u0, v1 };
+        for (int i = 0; i < 12; ++i) {
+            *position++ = quadPos[i];
+            *texCoord++ = quadUv[i];
+        }
+        x += glyph.advance;
+    }
+    // Characters without a glyph were skipped
+    GLsizei vertexCount = GLsizei(position - positions.data()) / 2;
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    program->bind();
+    QColor color = palette().color(QPalette::WindowText);
+    program->setUniformValue("atlas", 0);
+    program->setUniformValue(program->uniformLocation("color"),
+                             GLfloat(color.redF()), GLfloat(color.greenF()),
+                             GLfloat(color.blueF()), GLfloat(1.0));
+    program->enableAttributeArray(0);
+    program->enableAttributeArray(1);
+    program->setAttributeArray(0, positions.constData(), 2);
+    program->setAttributeArray(1, texCoords.constData(), 2);
+
+    glActiveTexture(GL_TEXTURE0);
+    atlas->bind();
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    atlas->release();
+
+    program->disableAttributeArray(0);
+    program->disableAttributeArray(1);
+    program->release();
+}
@@ -0,0 +1,63 @@
+#ifndef GLYPHDISPLAY_H
+#define GLYPHDISPLAY_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+// GPU replacement for the big QLabel. The fourteen glyphs the timer can show
+// (0-9, ':', the '.' of tenths and the '-' or '+' of overtime) are rasterised
+// once per font size into a texture atlas; a text change afterwards is just
+// a handful of textured quads.
+// Font and colour follow the widget's own font() and palette(), so it can
+// be driven exactly like the label (setText/setFont/setPalette).
+class GlyphDisplay : public QOpenGLWidget, protected QOpenGLFunctions {
+    Q_OBJECT
+
+public:
+    explicit GlyphDisplay(QWidget *parent = nullptr);
+    ~GlyphDisplay() override;
+
+    void setText(const QString &text);
+    QString text() const { return currentText; }
+
+    // True when a hardware OpenGL context can be created. Software
+    // rasterisers count as "no GPU", since they gain nothing over QLabel.
+    static bool isSupported();
+
+protected:
+    void initializeGL() override;
+    void paintGL() override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    static constexpr int GlyphCount = 14;
+    static constexpr int AtlasColumns = 4; // Glyph cells per atlas row
+
+    struct Glyph {
+        QRectF uv;        // Normalised texture coordinates in the atlas
+        qreal advance = 0; // Logical pixels
+    };
+
+    QString currentText;
+    std::unique_ptr<QOpenGLShaderProgram> program;
+    std::unique_ptr<QOpenGLTexture> atlas;
+    Glyph glyphs[GlyphCount];
+    qreal lineHeight = 0;
+    qreal ascent = 0;
+    qreal atlasDpr = 0;
+    bool atlasDirty = true;
+    // Vertex data for paintGL(), kept to reuse their capacity
+    QVector<GLfloat> positions;
+    QVector<GLfloat> texCoords;
+
+    static int glyphIndex(QChar ch);
+    void rebuildAtlas();
+};
+
+#endif // GLYPHDISPLAY_H
@@ -0,0 +1,7 @@
+#include "headlessrunner.h"
+
+// Core-only entry point: the same headless mode as "CountdownOvertimer
+// --headless", but linked without Widgets, Multimedia or OpenGL.
+int main(int argc, char *argv[]) {
+    return HeadlessRunner::run(argc, argv);
+}
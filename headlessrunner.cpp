@@ -0,0 +1,130 @@
+#include "headlessrunner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTcpSocket>
+#include <cstdio>
+#include <cstring>
+
+#include "assets.h"
+#include "statebroadcast.h"
+#include "timeformat.h"
+
+HeadlessRunner::HeadlessRunner(const TimerConfig &config, QObject *parent)
+    : QObject(parent), config(config) {
+    engine = new TimerEngine(this);
+    TimerSegment first = config.segment(0);
+    timerId = engine->addTimer(first.startMs(), first.limitMs());
+    texts.build(first.startMs(), first.limitMs(), first.format.layoutFor(first.startMs(), first.limitMs()),
+                first.format.overtime);
+    // Nobody watches a headless timer; let the OS batch its wakeups
+    engine->setVisible(timerId, false);
+
+    connect(engine, &TimerEngine::ticked, this, [this]() {
+        // Same per-second granularity as the on-screen display
+        const QString &text = texts.text(engine->remainingMs(timerId));
+        if (text == lastTickText) return;
+        lastTickText = text;
+        report("tick");
+    });
+    connect(engine, &TimerEngine::zeroReached, this, [this]() {
+        report("zero");
+    });
+    connect(engine, &TimerEngine::limitReached, this, [this]() {
+        report("limit");
+        // A playlist carries straight on with its next segment
+        if (segmentIndex + 1 < this->config.segmentCount()) {
+            TimerSegment next = this->config.segment(++segmentIndex);
+            if (publisher) publisher->setSegment(segmentIndex);
+            engine->configure(timerId, next.startMs(), next.limitMs());
+            texts.build(next.startMs(), next.limitMs(), next.format.layoutFor(next.startMs(), next.limitMs()),
+                        next.format.overtime);
+            start();
+            return;
+        }
+        // Let the final line reach the socket before the loop exits
+        if (socket) socket->flush();
+        QCoreApplication::quit();
+    });
+}
+
+void HeadlessRunner::connectTo(const QString &host, quint16 port) {
+    socket = new QTcpSocket(this);
+    socket->connectToHost(host, port);
+}
+
+void HeadlessRunner::publishTo(const QHostAddress &group, quint16 port) {
+    publisher = new StatePublisher(engine, timerId, group, port, this);
+    publisher->setSegment(segmentIndex);
+}
+
+void HeadlessRunner::start() {
+    engine->reset(timerId);
+    report("start");
+    engine->start(timerId);
+}
+
+void HeadlessRunner::report(const char *event) {
+    QByteArray line = QByteArray(event) + ' '
+                      + texts.text(engine->remainingMs(timerId)).toLatin1() + '\n';
+    if (socket) {
+        // Written once connected; Qt buffers anything sent while connecting
+        socket->write(line);
+    } else {
+        std::fwrite(line.constData(), 1, size_t(line.size()), stdout);
+        std::fflush(stdout);
+    }
+}
+
+bool HeadlessRunner::isRequested(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+int HeadlessRunner::run(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption headlessOption("headless", "Run without GUI or audio.");
+    parser.addOption(headlessOption);
+    QCommandLineOption eventsOption("events",
+        "Where to send events: stdout (default) or host:port for TCP.", "target", "stdout");
+    parser.addOption(eventsOption);
+    QCommandLineOption publishOption("publish",
+        "Mirror the countdown to followers over UDP multicast.", "group:port");
+    parser.addOption(publishOption);
+    parser.process(app);
+
+    QStringList errors;
+    HeadlessRunner runner(TimerConfig::load(Assets::locate("config.txt"), &errors));
+    for (const QString &error : errors) {
+        std::fprintf(stderr, "config.txt: %s\n", qPrintable(error));
+    }
+
+    QString target = parser.value(eventsOption);
+    if (target != "stdout") {
+        int colon = target.lastIndexOf(':');
+        quint16 port = colon > 0 ? target.mid(colon + 1).toUShort() : 0;
+        if (port == 0) {
+            std::fprintf(stderr, "Invalid --events target, expected host:port\n");
+            return 1;
+        }
+        runner.connectTo(target.left(colon), port);
+    }
+
+    if (parser.isSet(publishOption)) {
+        QHostAddress group;
+        quint16 groupPort = 0;
+        if (!StateWire::parseEndpoint(parser.value(publishOption), &group, &groupPort)) {
+            std::fprintf(stderr, "Invalid --publish endpoint, expected a multicast group:port\n");
+            return 1;
+        }
+        runner.publishTo(group, groupPort);
+    }
+
+    runner.start();
+    return app.exec();
+}
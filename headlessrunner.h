@@ -0,0 +1,57 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QString>
+
+#include "timeformat.h"
+#include "timerconfig.h"
+#include "timerengine.h"
+
+class QHostAddress;
+class QTcpSocket;
+class StatePublisher;
+
+// Runs the countdown from config.txt without any GUI or audio stack: only a
+// QCoreApplication, the TimerEngine and a text event stream. Starts
+// immediately, reports one line per event and quits once the limit is hit
+// (the last segment's limit, for a playlist):
+//
+//   start 40:00
+//   tick 39:59
+//   zero -00:00
+//   limit -15:00
+//
+// Events go to stdout, or to a TCP listener given as --events host:port.
+// With --publish the state is also multicast to "--follow" displays.
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(const TimerConfig &config, QObject *parent = nullptr);
+
+    // Send events to host:port instead of stdout
+    void connectTo(const QString &host, quint16 port);
+    // Also mirror the countdown to GUI followers (see StatePublisher)
+    void publishTo(const QHostAddress &group, quint16 port);
+    void start();
+
+    // True if argv asks for --headless
+    static bool isRequested(int argc, char *argv[]);
+    // Full headless entry point: builds its own QCoreApplication
+    static int run(int argc, char *argv[]);
+
+private:
+    TimerConfig config;
+    TimerEngine *engine;
+    TimerEngine::TimerId timerId;
+    int segmentIndex = 0;
+    QTcpSocket *socket = nullptr;
+    StatePublisher *publisher = nullptr;
+    CountdownTextTable texts;
+    QString lastTickText;
+
+    void report(const char *event);
+};
+
+#endif // HEADLESSRUNNER_H
@@ -0,0 +1,42 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+
+// Single-slot, latest-value-wins hand-over between two threads. One thread
+// only ever post()s and one other thread only ever take()s; neither call
+// blocks, allocates or spins. A value posted before the previous one was
+// taken replaces it, so the reader always sees the newest state and a slow
+// reader never holds up the writer.
+//
+// Triple buffered: the writer fills its own back slot and swaps it into the
+// middle, the reader swaps the middle out to its front slot. No slot is
+// ever read and written at the same time.
+template <typename T>
+class Mailbox {
+public:
+    void post(const T &value) {
+        buffers[back] = value;
+        int previous = middle.exchange(back | Fresh, std::memory_order_acq_rel);
+        back = previous & IndexMask;
+    }
+
+    // The newest value if one was posted since the last take()
+    bool take(T *value) {
+        if (!(middle.load(std::memory_order_relaxed) & Fresh)) return false;
+        int previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & IndexMask;
+        *value = buffers[front];
+        return true;
+    }
+
+private:
+    enum : int { IndexMask = 0x3, Fresh = 0x4 };
+
+    T buffers[3];
+    alignas(64) std::atomic<int> middle{1};
+    alignas(64) int back = 0;  // Writer's slot
+    alignas(64) int front = 2; // Reader's slot
+};
+
+#endif // MAILBOX_H
@@ -5,61 +5,159 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QTimer>
-#include <QFile>
-#include <QTextStream>
-#include <QMediaPlayer>
-#include <QAudioOutput>
-#include <QUrl>
 #include <QMessageBox>
-#include <QFileInfo>
-#include <QDateTime> 
+#include <QCommandLineParser>
 #include <QKeyEvent>    // Added for Keyboard Input
 #include <QResizeEvent> // Added for Window Resizing
+#include <QPaintEvent>
+#include <QPalette>
+#include <QWindow>
+#include <QScreen>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QDebug>
 #include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "assets.h"
+#include "audiocuecache.h"
+#include "configwatcher.h"
+#include "controlserver.h"
+#include "cuethread.h"
+#include "fontsizeresolver.h"
+#include "glyphdisplay.h"
+#include "headlessrunner.h"
+#include "metricsserver.h"
+#include "mirrorwindow.h"
+#include "processstats.h"
+#include "sessionjournal.h"
+#include "statebroadcast.h"
+#include "timeformat.h"
+#include "timerconfig.h"
+#include "tickstats.h"
+#include "timerengine.h"
+#include "timermetrics.h"
+#include "timesync.h"
+
+// Start-up choices made on the command line
+struct AppOptions {
+    enum class Renderer {
+        Auto,  // GPU glyph atlas when a hardware context is available, else QLabel
+        Gpu,
+        Label
+    };
+    Renderer renderer = Renderer::Auto;
+    int timers = 1; // Independent countdown windows sharing one engine
+
+    // Multicast state mirroring ("group:port"); at most one of the two is set
+    bool publish = false;
+    bool follow = false;
+    QHostAddress group;
+    quint16 port = StateWire::DefaultPort;
+    TimeSyncClient *timeSync = nullptr; // Followers: one for every window
+
+    // --metrics: recorded into by every window, from the GUI thread
+    TimerMetrics *metrics = nullptr;
+
+    // Report time-to-first-paint and time-to-audio-ready, then quit
+    bool measureStartup = false;
+    QElapsedTimer launchTimer; // Started first thing in main()
+};
 
 class TimerApp : public QWidget {
     Q_OBJECT
 
 public:
-    TimerApp(QWidget *parent = nullptr) : QWidget(parent) {
-        setWindowTitle("Negative Countdown Timer");
+    TimerApp(TimerEngine *engine, CueThread *cues, const AppOptions &options = AppOptions(),
+             QWidget *parent = nullptr)
+        : QWidget(parent), options(options), engine(engine), cues(cues) {
         resize(600, 400); // Slightly larger default start size
 
+        connect(qApp, &QGuiApplication::applicationStateChanged,
+                this, &TimerApp::updateVisibility);
+
+        timerId = engine->addTimer(0, 0);
+        connect(cues, &CueThread::cuesSettled, this, &TimerApp::onAudioReady);
+        connect(cues, &CueThread::cueFired, this, &TimerApp::onCueFired);
+        connect(cues, &CueThread::cueFailed, this, [this](int slot, const QString &error) {
+            if (slot == timerId) qWarning() << "Cannot decode sound:" << error;
+        });
         loadConfig();
         setupUI();
         resetTimer(); 
+
+        // Followers get their state from the publisher, not from disk
+        if (!options.follow) startJournal();
+
+        // Pick up edits to config.txt without a restart. With only the
+        // embedded default, creating one in the working directory counts.
+        QString configFile = Assets::locate("config.txt");
+        if (configFile.isEmpty() || Assets::isEmbedded(configFile)) configFile = "config.txt";
+        configWatcher = new ConfigWatcher(configFile, this);
+        connect(configWatcher, &ConfigWatcher::changed, this, &TimerApp::reloadConfig);
+    }
+
+    // Serve this window's timer over HTTP/WebSocket; false if the port
+    // could not be opened
+    bool enableRemoteControl(const QHostAddress &address, quint16 port) {
+        controlServer = new ControlServer(address, port, this);
+        if (!controlServer->start()) {
+            delete controlServer;
+            controlServer = nullptr;
+            return false;
+        }
+        connect(controlServer, &ControlServer::requestsPending,
+                this, &TimerApp::drainControlRequests);
+        connect(engine, &TimerEngine::stateChanged, this, [this](TimerEngine::TimerId id) {
+            if (id == timerId) publishControlState();
+        });
+        // Once a second as well, for status screens that just show "text"
+        connect(engine, &TimerEngine::ticked, this, &TimerApp::publishControlState);
+        publishControlState();
+        return true;
+    }
+
+    // Publish everything this window shows to feed, for mirror windows on
+    // other screens. Rendering then continues while any mirror is in view.
+    void setDisplayFeed(DisplayFeed *newFeed) {
+        feed = newFeed;
+        connect(feed, &DisplayFeed::viewersChanged, this, &TimerApp::updateVisibility);
+        renderCache.valid = false;
+        updateVisibility();
+        updateDisplay();
     }
 
 protected:
     // (1) Handle Window Resizing (Scaling the Text)
     void resizeEvent(QResizeEvent *event) override {
         QWidget::resizeEvent(event);
-        
-        // Calculate new font size dynamically
-        // We want the text to fit within the window, regardless of aspect ratio.
-        // "00:00" is 5 chars, "-15:00" is 6 chars. 
-        
-        int h = height();
-        int w = width();
-
-        // Heuristic: 
-        // 1. Height-based: Text should take up about 50% of screen height
-        // 2. Width-based: Width / 5 (roughly chars count)
-        int sizeByHeight = h * 0.50; 
-        int sizeByWidth = w / 4.5;   
 
-        // Pick the smaller one to ensure it fits inside the window
-        int newPointSize = std::min(sizeByHeight, sizeByWidth);
+        // Coalesce to at most one font update per frame. The first resize
+        // of a burst (e.g. a fullscreen toggle) applies immediately; the
+        // rest of an interactive drag is folded into the trailing update.
+        if (fontThrottle->isActive()) {
+            fontUpdatePending = true;
+            return;
+        }
+        applyFontSize();
+        fontThrottle->start();
+    }
 
-        // Set a minimum safety size so it doesn't disappear
-        if (newPointSize < 20) newPointSize = 20;
+    // (2) Bring audio up only once the first frame is on screen
+    void paintEvent(QPaintEvent *event) override {
+        QWidget::paintEvent(event);
+        if (firstPaintMs >= 0) return;
 
-        QFont font = lblDisplay->font();
-        font.setPointSize(newPointSize);
-        lblDisplay->setFont(font);
+        firstPaintMs = options.launchTimer.elapsed();
+        // Queued, so the frame is flushed before the backend initialises;
+        // decoding then runs asynchronously inside the backend.
+        QTimer::singleShot(0, this, [this]() { cues->initialize(timerId); });
     }
 
-    // (2) Handle Alt + Enter for Fullscreen
+    // (3) Handle Alt + Enter for Fullscreen
     void keyPressEvent(QKeyEvent *event) override {
         // Check for Alt + Enter (Key_Return is the main Enter, Key_Enter is Numpad Enter)
         if ((event->modifiers() & Qt::AltModifier) && 
@@ -73,80 +171,430 @@ protected:
             // Note: The resizeEvent() is called automatically by Qt 
             // when the window state changes, so the text will scale automatically.
             
+        } else if ((event->modifiers() & Qt::AltModifier) && event->key() == Qt::Key_J) {
+            // Alt+J toggles the timing overlay, Alt+Shift+J saves its samples
+            if (event->modifiers() & Qt::ShiftModifier) {
+                dumpTickStats();
+            } else {
+                toggleTickStats();
+            }
+        } else if (!options.follow && adjustKeyStep(event) != 0) {
+            // Moves the end time in place: no reset, no audio restart
+            adjustTime(adjustKeyStep(event));
+        } else if (!options.follow && event->key() == Qt::Key_Home) {
+            // Back to the start value without stopping
+            seekTime(engine->state(timerId).startMs);
         } else {
             // Pass other keys to the parent class
             QWidget::keyPressEvent(event);
         }
     }
 
+    // Up adds a minute and Down takes one away, 10 seconds with Shift;
+    // + and - always a minute (+ needs Shift on most layouts)
+    static qint64 adjustKeyStep(const QKeyEvent *event) {
+        qint64 step = (event->modifiers() & Qt::ShiftModifier) ? 10 * 1000 : 60 * 1000;
+        switch (event->key()) {
+        case Qt::Key_Up: return step;
+        case Qt::Key_Down: return -step;
+        case Qt::Key_Plus: return 60 * 1000;
+        case Qt::Key_Minus: return -60 * 1000;
+        default: return 0;
+        }
+    }
+
+    // (4) Stop rendering while nobody can see the window: minimised, hidden,
+    // fully covered or screen off (the last two arrive as expose changes)
+    void changeEvent(QEvent *event) override {
+        QWidget::changeEvent(event);
+        if (event->type() == QEvent::WindowStateChange) {
+            updateVisibility();
+        }
+    }
+
+    void showEvent(QShowEvent *event) override {
+        QWidget::showEvent(event);
+        if (!windowHooked && windowHandle()) {
+            windowHooked = true;
+            windowHandle()->installEventFilter(this);
+            connect(windowHandle(), &QWindow::visibilityChanged,
+                    this, &TimerApp::updateVisibility);
+        }
+        updateVisibility();
+    }
+
+    void hideEvent(QHideEvent *event) override {
+        QWidget::hideEvent(event);
+        updateVisibility();
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (watched == windowHandle() && event->type() == QEvent::Expose) {
+            updateVisibility();
+        }
+        return QWidget::eventFilter(watched, event);
+    }
+
+    // (5) Frame callbacks for the precision window, and whole-window
+    // repaint timing (children included) for the overlay
+    bool event(QEvent *event) override {
+        if (event->type() == QEvent::UpdateRequest && framesRunning) {
+            // Runs before the repaint below, so the new text is in this frame
+            onFrame();
+        }
+        if (options.metrics && event->type() == QEvent::UpdateRequest) {
+            options.metrics->increment(TimerMetrics::Repaints);
+        }
+        if (!tickStats || event->type() != QEvent::UpdateRequest) {
+            return QWidget::event(event);
+        }
+        QElapsedTimer paintTimer;
+        paintTimer.start();
+        bool handled = QWidget::event(event);
+        tickStats->record(TickStats::PaintDuration, paintTimer.nsecsElapsed() / 1000);
+        return handled;
+    }
+
 private:
+    AppOptions options;
+
     // --- Configuration Variables ---
-    int startMin = 0;
-    int startSec = 10;
-    int limitMin = 0;
-    int limitSec = 10;
-    QString soundZeroFile;
-    QString soundLimitFile;
+    TimerConfig config;
+    TimerSegment segment;      // The playlist entry on the clock (all of config without a playlist)
+    TimerSegment nextSegment;  // Resolved ahead of time by prefetchNextSegment()
+    int segmentIndex = 0;
+    ConfigWatcher *configWatcher;
 
     // --- State Variables ---
-    qint64 currentMs;       
-    qint64 limitMs;         
-    qint64 targetEndTime;   
-    bool isRunning = false;
-    bool isPaused = false;
-    bool zeroSoundPlayed = false; 
+    // The countdown itself (currentMs, targetEndTime, ...) lives in the
+    // shared engine; this window only displays and controls timerId.
+    TimerEngine *engine;
+    TimerEngine::TimerId timerId;
 
     // --- GUI Components ---
-    QLabel *lblDisplay;
+    QWidget *display;                     // Whichever of the two below is in use
+    QLabel *lblDisplay = nullptr;
+    GlyphDisplay *glyphDisplay = nullptr;
     QPushButton *btnStartPause;
     QPushButton *btnReset;
-    QTimer *timer;
     
+    // --- Render Cache ---
+    // Remembers what the label currently shows so updateDisplay() only
+    // touches the widget when the visible text or colour really changes.
+    struct RenderCache {
+        bool valid = false;
+        qint64 shownSteps = 0;        // |currentMs| in displayed units (s, or 0.1 s) last pushed
+        bool shownPrecise = false;    // Whether those units were tenths
+        bool shownNegative = false;   // Sign (and therefore colour) last pushed
+    } renderCache;
+    QPalette paletteNormal;
+    QPalette paletteOvertime;
+    // Every text the current segment can show, formatted up front
+    CountdownTextTable displayTexts;
+    // Tenths for the precision windows before zero and before the limit
+    CountdownTextTable zeroWindowTexts;
+    CountdownTextTable limitWindowTexts;
+    QString sizedForText;        // Widest text fontSizer was measured with
+    bool framesRunning = false;  // Redrawing on every frame (precision window)
+    bool displayShown = false;   // Someone can see the window or a mirror; nothing renders otherwise
+    DisplayFeed *feed = nullptr; // Mirrors on other screens (--screens)
+    bool windowHooked = false;   // Expose/visibility of windowHandle() are tracked
+
+    // --- Font Sizing ---
+    FontSizeResolver fontSizer;
+    QTimer *fontThrottle;
+    bool fontUpdatePending = false;
+    int appliedPointSize = 0;
+
     // --- Audio Components ---
-    QMediaPlayer *player;
-    QAudioOutput *audioOutput;
+    // Cues are decoded once in loadConfig() and played from memory by the
+    // shared cue thread, which walks the segment's timeline by itself from
+    // the position armCues() hands it. In a playlist the next segment's
+    // cues are decoded while this one runs.
+    CueThread *cues;
+    std::shared_ptr<const CueTimeline> timeline;
+    std::shared_ptr<const CueTimeline> nextTimeline;
+    bool changingTime = false; // Inside adjustTime()/seekTime()
+
+    // --- Crash Recovery ---
+    SessionJournal *journal = nullptr;
+
+    // --- Network Mirroring ---
+    StatePublisher *publisher = nullptr; // Only with --publish
+
+    // --- Remote Control ---
+    ControlServer *controlServer = nullptr; // Only with --control
+
+    // --- Startup Timing ---
+    qint64 firstPaintMs = -1;
+
+    // --- Timing Instrumentation ---
+    // Only exists while the Alt+J overlay is on
+    std::unique_ptr<TickStats> tickStats;
+    QLabel *statsOverlay = nullptr;
+    QString tickStatsSaved; // Last Alt+Shift+J result, shown under the numbers
 
     void loadConfig() {
-        QFile file("config.txt");
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            return; 
+        QStringList errors;
+        config = TimerConfig::load(Assets::locate("config.txt"), &errors);
+        checkSoundFiles(config, &errors);
+        if (!errors.isEmpty()) {
+            QMessageBox::warning(this, "config.txt",
+                                 "Some settings were ignored:\n\n" + errors.join('\n'));
         }
 
-        QTextStream in(&file);
-        
-        auto readValidLine = [&]() -> QString {
-            while (!in.atEnd()) {
-                QString line = in.readLine();
-                QString cleanLine = line.split('#')[0].trimmed();
-                if (!cleanLine.isEmpty()) return cleanLine;
+        selectSegment(0);
+    }
+
+    // Report missing sounds now, not as a beep at 00:00. Every segment is
+    // checked, so a playlist's last sound is not found missing an hour in.
+    static void checkSoundFiles(const TimerConfig &config, QStringList *errors) {
+        QStringList checked;
+        for (int i = 0; i < config.segmentCount(); ++i) {
+            TimerSegment segment = config.segment(i);
+            QStringList fileNames = { segment.soundZeroFile, segment.soundLimitFile };
+            for (const TimerWarning &warning : segment.warnings) fileNames.append(warning.soundFile);
+            for (const QString &fileName : fileNames) {
+                if (fileName.isEmpty() || checked.contains(fileName)) continue;
+                checked.append(fileName);
+                QString error;
+                if (AudioCueCache::resolve(fileName, &error).isEmpty()) errors->append(error);
             }
-            return QString();
-        };
-
-        startMin = readValidLine().toInt();
-        startSec = readValidLine().toInt();
-        limitMin = readValidLine().toInt();
-        limitSec = readValidLine().toInt();
-        soundZeroFile = readValidLine();
-        soundLimitFile = readValidLine();
-        
-        file.close();
+        }
+    }
+
+    bool hasNextSegment() const {
+        return segmentIndex + 1 < config.segmentCount();
+    }
+
+    // Put playlist entry index on the clock (not yet started)
+    void selectSegment(int index) {
+        segmentIndex = qBound(0, index, config.segmentCount() - 1);
+        segment = config.segment(segmentIndex);
+        if (publisher) publisher->setSegment(segmentIndex);
+        // Decode every cue now so playing them later costs no I/O or decode
+        timeline = loadCues(segment);
+        prefetchNextSegment();
+        updateWindowTitle();
+    }
+
+    // Resolve and start decoding the following segment while this one
+    // runs, so advanceSegment() is only a few assignments
+    void prefetchNextSegment() {
+        if (!hasNextSegment()) {
+            nextSegment = TimerSegment();
+            nextTimeline.reset();
+            return;
+        }
+        nextSegment = config.segment(segmentIndex + 1);
+        nextTimeline = loadCues(nextSegment);
+    }
+
+    // Load every sound segment plays and lay its cues out in countdown
+    // order. Cues without a sound stay silent, except warnings, which beep;
+    // so does a sound file that is missing.
+    std::shared_ptr<const CueTimeline> loadCues(const TimerSegment &segment) {
+        auto cueTimeline = std::make_shared<CueTimeline>();
+        if (!segment.soundZeroFile.isEmpty()) {
+            cueTimeline->add(0, CueTimeline::Kind::Zero, cues->load(timerId, segment.soundZeroFile));
+        }
+        if (!segment.soundLimitFile.isEmpty()) {
+            cueTimeline->add(segment.limitMs(), CueTimeline::Kind::Limit,
+                             cues->load(timerId, segment.soundLimitFile));
+        }
+        for (const TimerWarning &warning : segment.warnings) {
+            CueThread::CueId cue = warning.soundFile.isEmpty() ? CueThread::InvalidCue
+                                                               : cues->load(timerId, warning.soundFile);
+            cueTimeline->add(warning.atMs, CueTimeline::Kind::Warning, cue);
+        }
+        return cueTimeline;
+    }
+
+    // Switch straight into the next segment and keep counting. The limit
+    // cue that triggered the switch keeps playing, so there is no gap.
+    void advanceSegment() {
+        segmentIndex++;
+        segment = nextSegment;
+        if (publisher) publisher->setSegment(segmentIndex);
+        timeline = nextTimeline;
+        updateWindowTitle();
+
+        configureSegment();
+        engine->reset(timerId);
+        engine->start(timerId);
+        btnStartPause->setText("Pause");
+        updateDisplay();
+
+        prefetchNextSegment();
+    }
+
+    // Hand the current segment to the engine and intern every text it can
+    // show, so the tick path never formats
+    void configureSegment() {
+        qint64 startMs = segment.startMs();
+        qint64 limitMs = segment.limitMs();
+        engine->configure(timerId, startMs, limitMs);
+
+        // The formatter is picked here, once; the tables below are all the
+        // tick path ever looks at
+        const DisplayFormat &format = segment.format;
+        TimeLayout layout = format.layoutFor(startMs, limitMs);
+        displayTexts.build(startMs, limitMs, layout, format.overtime);
+        QString widest = widestCountdownText(startMs, limitMs, layout, format.overtime);
+
+        qint64 windowMs = segment.precisionSec * 1000LL;
+        if (windowMs > 0) {
+            // ss.t already shows tenths, so its window keeps the same digits
+            TimeLayout precise = layout == TimeLayout::SecondsTenths
+                                     ? TimeLayout::SecondsTenths
+                                     : TimeLayout::MinutesSecondsTenths;
+            zeroWindowTexts.build(windowMs - 1, 1, precise, format.overtime);
+            limitWindowTexts.build(limitMs + windowMs, limitMs + 1, precise, format.overtime);
+            // Size for both layouts so the digits don't jump on entering the window
+            QString tenths = widestCountdownText(startMs, limitMs, precise, format.overtime);
+            if (tenths.size() > widest.size()) widest = tenths;
+        }
+
+        if (widest != sizedForText) {
+            // Wider text (h:mm:ss, tenths) needs a smaller font for the same window
+            sizedForText = widest;
+            fontSizer = FontSizeResolver(display->font(), widest);
+            appliedPointSize = 0;
+            renderCache.valid = false;
+            applyFontSize();
+        }
+    }
+
+    // Within precisionSec before zero or before the limit
+    bool inPrecisionWindow(qint64 ms) const {
+        qint64 windowMs = segment.precisionSec * 1000LL;
+        if (windowMs <= 0) return false;
+        qint64 limitMs = segment.limitMs();
+        return (ms > 0 && ms < windowMs) || (ms > limitMs && ms <= limitMs + windowMs);
+    }
+
+    // Tenths on screen: in the precision window, or always for ss.t
+    bool showsTenths(qint64 ms) const {
+        return TimeFormat::hasTenths(displayTexts.layout()) || inPrecisionWindow(ms);
+    }
+
+    // Inside the precision window the display follows the screen's frame
+    // rate through requestUpdate(); outside it the engine's once-a-second
+    // tick is the only wakeup.
+    void startFrameLoop() {
+        if (framesRunning) return;
+        QWindow *window = windowHandle();
+        if (!window) return;
+        framesRunning = true;
+        window->requestUpdate();
+    }
+
+    void onFrame() {
+        qint64 nowRemaining = engine->remainingAt(timerId, engine->clock().nowMs());
+        if (!engine->isRunning(timerId) || !showsTenths(nowRemaining)) {
+            // The engine tick that ends the window takes over again
+            framesRunning = false;
+            return;
+        }
+        updateDisplay(nowRemaining);
+        windowHandle()->requestUpdate();
+    }
+
+    void updateWindowTitle() {
+        QString title = "Negative Countdown Timer";
+        if (!segment.name.isEmpty()) title = segment.name + " - " + title;
+        setWindowTitle(title);
+    }
+
+    // Apply an edited config.txt in place, rebuilding only what changed.
+    // A running countdown keeps its targetEndTime; a new stop time applies
+    // immediately and a new start time on the next reset.
+    void reloadConfig() {
+        QElapsedTimer reloadTimer;
+        reloadTimer.start();
+        QStringList errors;
+        TimerConfig updated = TimerConfig::load(Assets::locate("config.txt"), &errors);
+        checkSoundFiles(updated, &errors);
+        for (const QString &error : errors) {
+            qWarning() << "config.txt:" << error;
+        }
+
+        // Stay on the same playlist position if it still exists
+        TimerSegment current = updated.segment(segmentIndex);
+
+        // Saving config.txt is what re-checks a sound file. Only files
+        // that are new, or were missing before, are decoded again; the
+        // rest come back with the cue they already had.
+        timeline = loadCues(current);
+
+        bool timesChanged = !current.sameTiming(segment);
+        config = updated;
+        segmentIndex = qMin(segmentIndex, config.segmentCount() - 1);
+        segment = current;
+        if (publisher) publisher->setSegment(segmentIndex);
+        prefetchNextSegment();
+        updateWindowTitle();
+        if (timesChanged) {
+            CountdownState state = engine->state(timerId);
+            if (!state.isRunning && !state.isPaused && !state.limitReached) {
+                // Still showing the start value, so show the new one
+                resetTimer();
+            } else {
+                configureSegment();
+                updateDisplay();
+            }
+        }
+        // New sounds, warnings or a new stop time move the cue deadlines
+        armCues();
+        if (options.metrics) {
+            options.metrics->observe(TimerMetrics::ConfigReload, reloadTimer.nsecsElapsed() / 1000);
+        }
     }
 
     void setupUI() {
         QVBoxLayout *mainLayout = new QVBoxLayout(this);
 
         // 1. Timer Display
-        lblDisplay = new QLabel("00:00", this);
-        lblDisplay->setAlignment(Qt::AlignCenter);
-        QFont font = lblDisplay->font();
+        // Either the GPU glyph atlas or, without a usable GPU, the plain label
+        bool useGpu = options.renderer == AppOptions::Renderer::Gpu
+                      || (options.renderer == AppOptions::Renderer::Auto
+                          && GlyphDisplay::isSupported());
+        if (useGpu) {
+            glyphDisplay = new GlyphDisplay(this);
+            glyphDisplay->setText("00:00");
+            display = glyphDisplay;
+        } else {
+            lblDisplay = new QLabel("00:00", this);
+            lblDisplay->setAlignment(Qt::AlignCenter);
+            display = lblDisplay;
+        }
+        QFont font = display->font();
         font.setBold(true);
-        lblDisplay->setFont(font);
+        display->setFont(font);
+        fontSizer = FontSizeResolver(font);
+
+        fontThrottle = new QTimer(this);
+        fontThrottle->setSingleShot(true);
+        fontThrottle->setInterval(16); // ~one frame at 60 Hz
+        connect(fontThrottle, &QTimer::timeout, this, [this]() {
+            if (!fontUpdatePending) return;
+            fontUpdatePending = false;
+            applyFontSize();
+            fontThrottle->start();
+        });
         
-        // Allow the label to expand to fill available space
-        lblDisplay->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+        // Pre-built colours, swapped only when the sign flips. A palette
+        // change avoids the stylesheet re-parse and re-polish entirely.
+        paletteNormal = display->palette();
+        paletteNormal.setColor(QPalette::WindowText, Qt::black);
+        paletteOvertime = paletteNormal;
+        paletteOvertime.setColor(QPalette::WindowText, Qt::red);
+        display->setPalette(paletteNormal);
+
+        // Allow the display to expand to fill available space
+        display->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
         
-        mainLayout->addWidget(lblDisplay);
+        mainLayout->addWidget(display);
 
         // 2. Button Layout
         QHBoxLayout *btnLayout = new QHBoxLayout();
@@ -164,124 +612,581 @@ private:
         mainLayout->addLayout(btnLayout);
 
         // 3. Timer Setup
-        timer = new QTimer(this);
-        timer->setInterval(50); 
-        connect(timer, &QTimer::timeout, this, &TimerApp::onTick);
+        // The engine ticks once per displayed second for every window
+        connect(engine, &TimerEngine::ticked, this, &TimerApp::onTick);
+        connect(engine, &TimerEngine::limitReached, this, &TimerApp::onLimitReached);
+        // The cues themselves are played by the cue thread
+        connect(engine, &TimerEngine::stateChanged, this, [this](TimerEngine::TimerId id) {
+            if (id == timerId) armCues();
+        });
+        connect(engine, &TimerEngine::zeroReached, this, [this](TimerEngine::TimerId id) {
+            if (id == timerId && changingTime) playCue(CueTimeline::Kind::Zero);
+        });
 
-        // 4. Audio Setup
-        player = new QMediaPlayer(this);
-        audioOutput = new QAudioOutput(this);
-        player->setAudioOutput(audioOutput);
-        audioOutput->setVolume(1.0); 
+        // 4. Network Mirroring
+        if (options.publish) {
+            publisher = new StatePublisher(engine, timerId, options.group, options.port, this);
+            publisher->setSegment(segmentIndex);
+        } else if (options.follow) {
+            // Followers are driven entirely by the publisher, down to which
+            // segment's format, name and cues they show
+            auto *follower = new StateFollower(engine, timerId, options.group, options.port, this);
+            follower->setTimeSync(options.timeSync);
+            connect(follower, &StateFollower::segmentChanged, this, [this](int index) {
+                if (index == segmentIndex) return;
+                selectSegment(index);
+                configureSegment(); // The snapshot that follows sets the times
+            });
+            btnStartPause->setVisible(false);
+            btnReset->setVisible(false);
+        }
     }
 
     void updateDisplay() {
-        qint64 absMs = std::abs(currentMs);
-        qint64 totalSeconds = absMs / 1000; 
+        updateDisplay(engine->remainingMs(timerId));
+    }
 
-        int m = totalSeconds / 60;
-        int s = totalSeconds % 60;
+    void updateDisplay(qint64 currentMs) {
+        // Nothing is drawn while hidden; updateVisibility() catches up
+        if (!displayShown) return;
 
-        QString sign = (currentMs < 0) ? "-" : "";
-        
-        if (currentMs < 0 && currentMs > -1000) {
-            sign = "-";
+        if (!tickStats && !options.metrics) {
+            renderDisplay(currentMs);
+        } else {
+            QElapsedTimer updateTimer;
+            updateTimer.start();
+            renderDisplay(currentMs);
+            qint64 durationUs = updateTimer.nsecsElapsed() / 1000;
+            if (tickStats) tickStats->record(TickStats::UpdateDuration, durationUs);
+            if (options.metrics) options.metrics->observe(TimerMetrics::UpdateDuration, durationUs);
+        }
+
+        if (!framesRunning && engine->isRunning(timerId) && showsTenths(currentMs)) {
+            startFrameLoop();
         }
+    }
+
+    void renderDisplay(qint64 currentMs) {
+        bool precise = showsTenths(currentMs);
+        bool inWindow = inPrecisionWindow(currentMs);
+        qint64 absMs = std::abs(currentMs);
+        qint64 shownSteps = absMs / (precise ? 100 : 1000);
+        bool negative = currentMs < 0;
+
+        if (options.metrics) options.metrics->increment(TimerMetrics::DisplayUpdates);
+        bool textChanged = !renderCache.valid
+                           || shownSteps != renderCache.shownSteps
+                           || precise != renderCache.shownPrecise
+                           || negative != renderCache.shownNegative;
+        if (!textChanged) {
+            // Would have repainted identical output
+            if (options.metrics) options.metrics->increment(TimerMetrics::SkippedUpdates);
+            return;
+        }
+
+        const QString &text = !inWindow ? displayTexts.text(currentMs)
+                              : currentMs > 0 ? zeroWindowTexts.text(currentMs)
+                                              : limitWindowTexts.text(currentMs);
+        setDisplayText(text);
+        if (feed) feed->publish(text, negative, sizedForText);
 
-        QString timeStr = QString("%1%2:%3")
-                            .arg(sign)
-                            .arg(m, 2, 10, QChar('0'))
-                            .arg(s, 2, 10, QChar('0'));
+        if (!renderCache.valid || negative != renderCache.shownNegative) {
+            display->setPalette(negative ? paletteOvertime : paletteNormal);
+        }
 
-        lblDisplay->setText(timeStr);
+        renderCache.valid = true;
+        renderCache.shownSteps = shownSteps;
+        renderCache.shownPrecise = precise;
+        renderCache.shownNegative = negative;
+    }
 
-        if (currentMs < 0) {
-            lblDisplay->setStyleSheet("color: red;");
+    void setDisplayText(const QString &text) {
+        if (glyphDisplay) {
+            glyphDisplay->setText(text);
         } else {
-            lblDisplay->setStyleSheet("color: black;");
+            lblDisplay->setText(text);
+        }
+    }
+
+    void applyFontSize() {
+        // Text should fit within the window regardless of aspect ratio;
+        // the resolver measured the widest possible text (e.g. "-88:88") once.
+        int newPointSize = fontSizer.pointSizeFor(size());
+        if (newPointSize == appliedPointSize) return;
+
+        appliedPointSize = newPointSize;
+        QFont font = display->font();
+        font.setPointSize(newPointSize);
+        display->setFont(font);
+    }
+
+    void updateVisibility() {
+        QWindow *window = windowHandle();
+        Qt::ApplicationState appState = QGuiApplication::applicationState();
+        bool visible = isVisible() && !isMinimized()
+                       && (!window || window->isExposed())
+                       && appState != Qt::ApplicationHidden
+                       && appState != Qt::ApplicationSuspended;
+        if (feed && feed->hasViewers()) visible = true;
+        bool becameVisible = visible && !displayShown;
+
+        // Set first: the engine catches up with an immediate tick when a
+        // timer comes back into view, and that tick must render
+        displayShown = visible;
+        engine->setVisible(timerId, visible);
+        if (becameVisible) {
+            // Paused or idle timers get no tick, so draw the current state here
+            updateDisplay();
+        } else if (!visible) {
+            // Frames are not delivered while hidden; the next tick restarts them
+            framesRunning = false;
+        }
+    }
+
+    void toggleTickStats() {
+        if (tickStats) {
+            tickStats.reset();
+            tickStatsSaved.clear();
+            statsOverlay->hide();
+            return;
+        }
+
+        tickStats = std::make_unique<TickStats>();
+        if (!statsOverlay) {
+            // Floats over the display, outside the layout
+            statsOverlay = new QLabel(this);
+            statsOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+            statsOverlay->setStyleSheet("background: rgba(0, 0, 0, 160); color: white; padding: 4px;");
+            QFont mono("Monospace");
+            mono.setStyleHint(QFont::TypeWriter);
+            statsOverlay->setFont(mono);
+            statsOverlay->move(8, 8);
         }
+        refreshTickStats();
+        statsOverlay->show();
+        statsOverlay->raise();
     }
 
-    void playSound(const QString &fileName) {
-        if (fileName.isEmpty()) return;
+    void refreshTickStats() {
+        QString text = tickStats->summaryText();
+        if (!tickStatsSaved.isEmpty()) text += '\n' + tickStatsSaved;
+        statsOverlay->setText(text);
+        statsOverlay->adjustSize();
+    }
 
-        QFileInfo checkFile(fileName);
-        if (checkFile.exists() && checkFile.isFile()) {
-            player->stop(); 
-            player->setSource(QUrl::fromLocalFile(checkFile.absoluteFilePath()));
-            player->play();
+    void dumpTickStats() {
+        if (!tickStats) return;
+
+        QString fileName = QString("tickstats-%1.csv")
+                               .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+        if (tickStats->writeCsv(fileName)) {
+            tickStatsSaved = "Saved " + fileName;
         } else {
-            QApplication::beep();
+            tickStatsSaved = "Could not write " + fileName;
+            qWarning() << "Could not write" << fileName;
+        }
+        refreshTickStats();
+    }
+
+    // Resume whatever a crashed or rebooted session left behind, then
+    // record every transition from here on
+    void startJournal() {
+        QString fileName = timerId == 0 ? QString("session.journal")
+                                        : QString("session-%1.journal").arg(timerId + 1);
+        journal = new SessionJournal(fileName, this);
+        if (!journal->open()) {
+            qWarning() << "Cannot open" << fileName << "- this session will not survive a restart";
+            delete journal;
+            journal = nullptr;
+            return;
+        }
+        if (journal->hasLast()) resumeSession(journal->last());
+
+        connect(engine, &TimerEngine::stateChanged, this, [this](TimerEngine::TimerId id) {
+            if (id == timerId) recordStateChange();
+        });
+        connect(engine, &TimerEngine::zeroReached, this, [this](TimerEngine::TimerId id) {
+            if (id == timerId) recordTransition(SessionJournal::Event::ZeroReached);
+        });
+    }
+
+    bool resumeSession(const SessionJournal::Record &record) {
+        CountdownState state = SessionJournal::stateAt(record, QDateTime::currentMSecsSinceEpoch());
+        // Never started, or it ran out while we were down: start fresh
+        if (!state.isRunning && !state.isPaused && !state.limitReached) return false;
+        if (state.isRunning && state.currentMs <= state.limitMs) return false;
+
+        // Only while config.txt still describes the same countdown
+        if (record.segment >= config.segmentCount()) return false;
+        TimerSegment recorded = config.segment(record.segment);
+        if (recorded.limitMs() != state.limitMs) return false;
+        if (!recorded.endAt.isValid() && recorded.startMs() != state.startMs) return false;
+
+        if (record.segment != segmentIndex) selectSegment(record.segment);
+        configureSegment();
+        engine->applySnapshot(timerId, state);
+
+        btnStartPause->setText(state.isRunning ? "Pause" : "Start");
+        btnStartPause->setVisible(!state.limitReached);
+        updateDisplay();
+        return true;
+    }
+
+    void recordStateChange() {
+        CountdownState state = engine->state(timerId);
+        SessionJournal::Event event = state.limitReached ? SessionJournal::Event::LimitReached
+                                      : state.isRunning  ? SessionJournal::Event::Started
+                                      : state.isPaused   ? SessionJournal::Event::Paused
+                                                         : SessionJournal::Event::Reset;
+        recordTransition(event);
+    }
+
+    void recordTransition(SessionJournal::Event event) {
+        journal->append(event, engine->state(timerId),
+                        engine->remainingAt(timerId, engine->clock().nowMs()), segmentIndex);
+    }
+
+    // Tell the cue thread where this timer is on its cue timeline. Called
+    // on every state change (start, pause, reset, adjust), so it always has
+    // the current targetEndTime; nothing about cues happens per tick.
+    void armCues() {
+        CountdownState state = engine->state(timerId);
+        CueThread::Arming arming;
+        arming.timeline = timeline;
+        if (state.isRunning) {
+            arming.endAtMs = state.targetEndTime;
+            arming.remainingMs = engine->remainingAt(timerId, engine->clock().nowMs());
         }
+        cues->arm(timerId, arming);
+    }
+
+    // Move the end time in place. The engine reports a zero or limit these
+    // reach before returning, once armCues() has moved past it, so those
+    // cues are played here; warnings jumped over stay silent.
+    void adjustTime(qint64 deltaMs) {
+        changingTime = true;
+        engine->adjust(timerId, deltaMs);
+        changingTime = false;
+    }
+
+    void seekTime(qint64 remainingMs) {
+        changingTime = true;
+        engine->seek(timerId, remainingMs);
+        changingTime = false;
+    }
+
+    void playCue(CueTimeline::Kind kind) {
+        int index = timeline ? timeline->indexOf(kind) : -1;
+        if (index >= 0) cues->play(timerId, kind, timeline->at(index).cue);
     }
 
 private slots:
     void onResetClicked() {
+        // A finished playlist starts over from its first segment
+        if (!hasNextSegment() && engine->state(timerId).limitReached) {
+            selectSegment(0);
+        }
         resetTimer();
     }
 
     void resetTimer() {
-        timer->stop();
-        player->stop();
-        isRunning = false;
-        isPaused = false;
-        zeroSoundPlayed = false;
-
-        currentMs = ((startMin * 60) + startSec) * 1000;
-        limitMs = -1 * ((limitMin * 60) + limitSec) * 1000;
+        cues->stopAll(timerId);
+        configureSegment();
+        engine->reset(timerId);
 
         btnStartPause->setText("Start");
-        btnStartPause->setVisible(true);
+        btnStartPause->setVisible(!options.follow);
         updateDisplay();
         
-        // Force a resize event to ensure font is correct size on startup/reset
-        QResizeEvent *event = new QResizeEvent(this->size(), this->size());
-        QCoreApplication::postEvent(this, event);
+        // Make sure the font matches the window on startup/reset (no-op if unchanged)
+        applyFontSize();
     }
 
     void onStartPauseClicked() {
-        if (!isRunning) {
-            isRunning = true;
-            isPaused = false;
+        if (!engine->isRunning(timerId)) {
             btnStartPause->setText("Pause");
-            targetEndTime = QDateTime::currentMSecsSinceEpoch() + currentMs;
-            timer->start();
+            // "end_at" targets are measured from the moment Start is pressed
+            CountdownState state = engine->state(timerId);
+            if (segment.endAt.isValid() && !state.isPaused) {
+                configureSegment();
+                engine->reset(timerId);
+            }
+            engine->start(timerId);
+            updateDisplay(); // Resuming inside the precision window restarts the frames
         } else {
-            isRunning = false;
-            isPaused = true;
             btnStartPause->setText("Start");
-            timer->stop();
+            engine->pause(timerId);
         }
     }
 
     void onTick() {
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
-        currentMs = targetEndTime - now;
-        
+        if (!tickStats) {
+            updateDisplay();
+            return;
+        }
+
+        qint64 latenessUs = engine->tickLatenessUs();
+        if (latenessUs >= 0) tickStats->record(TickStats::TickLateness, latenessUs);
         updateDisplay();
+        refreshTickStats();
+    }
+
+    // Commands go through the same paths as the buttons, so the button
+    // text and playlist handling stay in step
+    void drainControlRequests() {
+        ControlServer::Request request;
+        while (controlServer->takeRequest(&request)) {
+            bool running = engine->isRunning(timerId);
+            bool finished = engine->state(timerId).limitReached;
+            switch (request.command) {
+            case ControlServer::Command::Start:
+                if (!running && !finished) onStartPauseClicked();
+                break;
+            case ControlServer::Command::Pause:
+                if (running) onStartPauseClicked();
+                break;
+            case ControlServer::Command::Toggle:
+                if (!finished) onStartPauseClicked();
+                break;
+            case ControlServer::Command::Reset:
+                onResetClicked();
+                break;
+            case ControlServer::Command::Adjust:
+                // Zero or the limit reached this way is reported (and
+                // published) before the next request is taken
+                adjustTime(request.ms);
+                break;
+            case ControlServer::Command::Seek:
+                seekTime(request.ms);
+                break;
+            }
+        }
+    }
+
+    void publishControlState() {
+        CountdownState state = engine->state(timerId);
+        ControlServer::State published;
+        published.running = state.isRunning;
+        published.paused = state.isPaused;
+        published.limitReached = state.limitReached;
+        published.remainingMs = engine->remainingAt(timerId, engine->clock().nowMs());
+        published.startMs = state.startMs;
+        published.limitMs = state.limitMs;
+        // The same layout configureSegment() picked for the display
+        published.layout = segment.format.layoutFor(state.startMs, state.limitMs);
+        published.overtime = segment.format.overtime;
+        controlServer->publish(published);
+    }
+
+    void onAudioReady(int slot) {
+        if (slot != timerId || !options.measureStartup) return;
+
+        qint64 audioReadyMs = options.launchTimer.elapsed();
+        std::printf("first_paint_ms=%lld audio_ready_ms=%lld peak_rss_kb=%lld\n",
+                    static_cast<long long>(firstPaintMs),
+                    static_cast<long long>(audioReadyMs),
+                    static_cast<long long>(peakResidentKb()));
+        std::fflush(stdout);
+        QCoreApplication::quit();
+    }
 
-        if (currentMs <= 0 && !zeroSoundPlayed) {
-            playSound(soundZeroFile);
-            zeroSoundPlayed = true;
+    void onCueFired(int slot, CueThread::Report report) {
+        if (slot != timerId) return;
+        if (tickStats) tickStats->record(TickStats::CueLateness, report.latenessUs);
+        // Missing files, or a cue that failed to decode, still get an audible signal
+        if (!report.played) {
+            if (options.metrics) options.metrics->increment(TimerMetrics::CuesMissed);
+            QApplication::beep();
         }
+    }
 
-        if (currentMs <= limitMs) {
-            currentMs = limitMs; 
-            updateDisplay();
-            playSound(soundLimitFile);
-            timer->stop();
-            isRunning = false;
-            isPaused = true;
-            btnStartPause->setVisible(false);
+    void onLimitReached(TimerEngine::TimerId id) {
+        if (id != timerId) return;
+
+        // The engine has already clamped the time to the limit and stopped;
+        // the cue thread has played (or is playing) the limit cue, unless
+        // a change of time jumped here. Before the next segment's timeline
+        // replaces this one.
+        if (changingTime) playCue(CueTimeline::Kind::Limit);
+        updateDisplay();
+
+        // Playlists roll on by themselves; followers get the switch from the publisher
+        if (hasNextSegment() && !options.follow) {
+            advanceSegment();
+            return;
         }
+        btnStartPause->setVisible(false);
     }
 };
 
+// "[host:]port" for a listening socket; a bare port means 127.0.0.1 only
+static bool parseListenEndpoint(const QString &endpoint, QHostAddress *address, quint16 *port) {
+    *address = QHostAddress(QHostAddress::LocalHost);
+    QString portText = endpoint;
+    qsizetype colon = endpoint.lastIndexOf(':');
+    if (colon >= 0) {
+        *address = QHostAddress(endpoint.left(colon));
+        portText = endpoint.mid(colon + 1);
+    }
+    bool ok = false;
+    *port = portText.toUShort(&ok);
+    return ok && *port != 0 && !address->isNull();
+}
+
 int main(int argc, char *argv[]) {
+    QElapsedTimer launchTimer;
+    launchTimer.start();
+
+    // Headless mode must decide before any GUI application object exists,
+    // so that no display connection or audio backend is ever opened.
+    if (HeadlessRunner::isRequested(argc, argv)) {
+        // Its event lines go to stdout, which a WIN32 executable lacks
+        attachParentConsole();
+        return HeadlessRunner::run(argc, argv);
+    }
+
     QApplication app(argc, argv);
-    TimerApp window;
-    window.show();
-    return app.exec();
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption rendererOption("renderer",
+        "Display renderer: auto, gpu or label (default: auto).", "mode", "auto");
+    parser.addOption(rendererOption);
+    QCommandLineOption timersOption("timers",
+        "Number of independent countdown windows (default: 1).", "count", "1");
+    parser.addOption(timersOption);
+    QCommandLineOption publishOption("publish",
+        "Mirror this timer to followers over UDP multicast.", "group:port");
+    parser.addOption(publishOption);
+    QCommandLineOption followOption("follow",
+        "Display the timer published on a multicast group.", "group:port");
+    parser.addOption(followOption);
+    QCommandLineOption controlOption("control",
+        "Accept remote control over HTTP/WebSocket (no authentication; a bare port binds 127.0.0.1).",
+        "[host:]port");
+    parser.addOption(controlOption);
+    QCommandLineOption metricsOption("metrics",
+        "Serve Prometheus metrics on GET /metrics (a bare port binds 127.0.0.1).",
+        "[host:]port");
+    parser.addOption(metricsOption);
+    QCommandLineOption screensOption("screens",
+        "Mirror the first timer full-screen on every other screen.");
+    parser.addOption(screensOption);
+    QCommandLineOption measureStartupOption("measure-startup",
+        "Print time-to-first-paint and time-to-audio-ready in ms, then quit.");
+    parser.addOption(measureStartupOption);
+    parser.process(app);
+
+    AppOptions options;
+    options.launchTimer = launchTimer;
+    options.measureStartup = parser.isSet(measureStartupOption);
+    if (options.measureStartup) attachParentConsole();
+    QString renderer = parser.value(rendererOption);
+    if (renderer == "gpu") {
+        options.renderer = AppOptions::Renderer::Gpu;
+    } else if (renderer == "label") {
+        options.renderer = AppOptions::Renderer::Label;
+    }
+    options.timers = qMax(1, parser.value(timersOption).toInt());
+
+    options.publish = parser.isSet(publishOption);
+    options.follow = !options.publish && parser.isSet(followOption);
+    if (options.publish || options.follow) {
+        QString endpoint = parser.value(options.publish ? publishOption : followOption);
+        if (!StateWire::parseEndpoint(endpoint, &options.group, &options.port)) {
+            QMessageBox::critical(nullptr, "Countdown Overtimer",
+                                  QString("Invalid multicast endpoint: %1").arg(endpoint));
+            return 1;
+        }
+    }
+
+    // Fleet monitoring, followers included. Recorded by the windows and
+    // the cue thread, scraped on the server's own thread.
+    std::unique_ptr<TimerMetrics> metrics;
+    std::unique_ptr<MetricsServer> metricsServer;
+    if (parser.isSet(metricsOption)) {
+        QString endpoint = parser.value(metricsOption);
+        QHostAddress address;
+        quint16 port = 0;
+        metrics = std::make_unique<TimerMetrics>();
+        if (parseListenEndpoint(endpoint, &address, &port)) {
+            metricsServer = std::make_unique<MetricsServer>(metrics.get(), address, port);
+        }
+        if (!metricsServer || !metricsServer->start()) {
+            QMessageBox::critical(nullptr, "Countdown Overtimer",
+                                  QString("Cannot serve metrics on %1").arg(endpoint));
+            return 1;
+        }
+        options.metrics = metrics.get();
+    }
+
+    // One engine and one event loop drive every window. With every window
+    // out of sight it only wakes for the next cue.
+    TimerEngine engine;
+    engine.setIdleWhenHidden(true);
+    if (metrics) {
+        // Once per tick, however many windows it drives
+        QObject::connect(&engine, &TimerEngine::ticked, metricsServer.get(), [&engine, &metrics]() {
+            qint64 latenessUs = engine.tickLatenessUs();
+            if (latenessUs >= 0) metrics->observe(TimerMetrics::TickLateness, latenessUs);
+        });
+    }
+    // Followers count on the publisher's timeline, so every screen shows
+    // the same time at the same moment. Set before the cue thread takes
+    // the clock.
+    std::unique_ptr<TimeSyncClient> timeSync;
+    if (options.follow) {
+        auto clock = std::make_unique<SyncedClock>();
+        timeSync = std::make_unique<TimeSyncClient>(clock.get(), &engine);
+        engine.setClock(std::move(clock));
+        options.timeSync = timeSync.get();
+    }
+    // Cues are triggered off the GUI thread, from the same deadlines
+    CueThread cueThread(&engine.clock(), options.timers);
+    cueThread.setMetrics(metrics.get());
+    cueThread.start();
+    DisplayFeed feed; // Outlives the windows reading it
+    std::vector<std::unique_ptr<TimerApp>> windows;
+    for (int i = 0; i < options.timers; ++i) {
+        windows.push_back(std::make_unique<TimerApp>(&engine, &cueThread, options));
+        windows.back()->show();
+    }
+
+    // One mirror per extra screen, following screens as they come and go
+    QHash<QScreen *, MirrorWindow *> mirrors;
+    auto addMirror = [&feed, &mirrors](QScreen *screen) {
+        if (screen == QGuiApplication::primaryScreen() || mirrors.contains(screen)) return;
+        MirrorWindow *mirror = new MirrorWindow(&feed, screen);
+        mirrors.insert(screen, mirror);
+        mirror->showFullScreen();
+    };
+    if (parser.isSet(screensOption)) {
+        windows.front()->setDisplayFeed(&feed);
+        for (QScreen *screen : QGuiApplication::screens()) addMirror(screen);
+        QObject::connect(&app, &QGuiApplication::screenAdded, &feed, addMirror);
+        QObject::connect(&app, &QGuiApplication::screenRemoved, &feed, [&mirrors](QScreen *screen) {
+            delete mirrors.take(screen);
+        });
+    }
+
+    // Remote control drives the first window. Followers take their state
+    // from the publisher, so there is nothing for it to control.
+    if (parser.isSet(controlOption)) {
+        QString endpoint = parser.value(controlOption);
+        QHostAddress address;
+        quint16 port = 0;
+        bool ok = parseListenEndpoint(endpoint, &address, &port);
+        if (options.follow) {
+            qWarning() << "--control is ignored with --follow";
+        } else if (!ok || !windows.front()->enableRemoteControl(address, port)) {
+            QMessageBox::critical(nullptr, "Countdown Overtimer",
+                                  QString("Cannot listen for remote control on %1").arg(endpoint));
+            return 1;
+        }
+    }
+    int result = app.exec();
+    qDeleteAll(mirrors);
+    return result;
 }
 
 #include "main.moc"
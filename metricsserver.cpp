@@ -0,0 +1,79 @@
+#include "metricsserver.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+
+#include "timermetrics.h"
+
+namespace {
+
+QByteArray httpResponse(int status, const char *reason, const QByteArray &contentType,
+                        const QByteArray &body) {
+    return "HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n"
+           + "Content-Type: " + contentType + "\r\n"
+           + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           + "Connection: close\r\n\r\n" + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(const TimerMetrics *metrics, const QHostAddress &address,
+                             quint16 port, QObject *parent)
+    : QObject(parent), metrics(metrics), address(address), port(port) {}
+
+MetricsServer::~MetricsServer() {
+    if (!thread) return;
+    // The server and its sockets are deleted on their own thread as it finishes
+    thread->quit();
+    thread->wait();
+}
+
+bool MetricsServer::start() {
+    thread = new QThread(this);
+    thread->setObjectName("MetricsServer");
+    server = new QTcpServer;
+    server->moveToThread(thread);
+    connect(thread, &QThread::finished, server, &QObject::deleteLater);
+    connect(server, &QTcpServer::newConnection, server, [this]() { acceptPending(); });
+    thread->start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(server, [this, &listening]() {
+        listening = server->listen(address, port);
+    }, Qt::BlockingQueuedConnection);
+    return listening;
+}
+
+void MetricsServer::acceptPending() {
+    while (server->hasPendingConnections()) {
+        // Children of the server, so they go with it
+        QTcpSocket *socket = server->nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, server, [this, socket]() { readRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsServer::readRequest(QTcpSocket *socket) {
+    // Only the request line matters; the rest is read and dropped
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > MaxRequestBytes) socket->abort();
+        return;
+    }
+    QList<QByteArray> requestLine = socket->readLine(MaxRequestBytes).trimmed().split(' ');
+    socket->disconnect(server); // One request per connection
+    QByteArray method = requestLine.value(0);
+    QByteArray path = requestLine.value(1);
+    qsizetype query = path.indexOf('?');
+    if (query >= 0) path = path.left(query);
+
+    if (path != "/metrics") {
+        socket->write(httpResponse(404, "Not Found", "text/plain", "not found\n"));
+    } else if (method != "GET") {
+        socket->write(httpResponse(405, "Method Not Allowed", "text/plain", "use GET\n"));
+    } else {
+        socket->write(httpResponse(200, "OK", "text/plain; version=0.0.4",
+                                   metrics->prometheusText()));
+    }
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,45 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QHostAddress>
+#include <QObject>
+
+class QThread;
+class QTcpServer;
+class QTcpSocket;
+class TimerMetrics;
+
+// Serves TimerMetrics for Prometheus to scrape:
+//
+//   GET /metrics   text exposition format
+//
+// Like ControlServer it runs on its own thread, and a scrape only reads
+// the metrics' atomics there, so a scraper never waits on the GUI thread
+// and the GUI thread never waits on a scraper.
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+public:
+    MetricsServer(const TimerMetrics *metrics, const QHostAddress &address, quint16 port,
+                  QObject *parent = nullptr);
+    ~MetricsServer() override;
+
+    // Starts the server thread and opens the port; false if it could not
+    // be opened.
+    bool start();
+
+private:
+    static constexpr int MaxRequestBytes = 8 * 1024;
+
+    const TimerMetrics *metrics;
+    QHostAddress address;
+    quint16 port;
+    QThread *thread = nullptr;
+    QTcpServer *server = nullptr; // Lives on thread
+
+    // Server thread only
+    void acceptPending();
+    void readRequest(QTcpSocket *socket);
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,30 @@
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+
+#include "minimalwindow.h"
+#include "processstats.h"
+
+// Entry point of the minimal kiosk build: QtGui only, no Widgets, no
+// Multimedia, no OpenGL and no network. See COUNTDOWN_BUILD_MINIMAL.
+int main(int argc, char *argv[]) {
+    QElapsedTimer launchTimer;
+    launchTimer.start();
+
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption measureStartupOption("measure-startup",
+        "Print time-to-first-paint, time-to-audio-ready in ms and peak RSS, then quit.");
+    parser.addOption(measureStartupOption);
+    parser.process(app);
+
+    bool measureStartup = parser.isSet(measureStartupOption);
+    if (measureStartup) attachParentConsole();
+
+    MinimalWindow window(launchTimer, measureStartup);
+    window.resize(640, 360);
+    window.show();
+    return app.exec();
+}
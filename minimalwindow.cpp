@@ -0,0 +1,213 @@
+#include "minimalwindow.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <cstdio>
+
+#include "assets.h"
+#include "processstats.h"
+
+MinimalWindow::MinimalWindow(const QElapsedTimer &launchTimer, bool measureStartup)
+    : launchTimer(launchTimer), measureStartup(measureStartup) {
+    setTitle("Countdown Overtimer");
+
+    QStringList errors;
+    config = TimerConfig::load(Assets::locate("config.txt"), &errors);
+    for (const QString &error : errors) {
+        qWarning() << "config.txt:" << error;
+    }
+
+    engine = new TimerEngine(this);
+    timerId = engine->addTimer(0, 0);
+    connect(engine, &TimerEngine::ticked, this, &MinimalWindow::onTick);
+    connect(engine, &TimerEngine::limitReached, this, &MinimalWindow::onLimitReached);
+    // Start, pause, reset or a change of time: find the next cue again.
+    // Cues the countdown jumped over are not played late.
+    connect(engine, &TimerEngine::stateChanged, this, [this](TimerEngine::TimerId id) {
+        if (id == timerId) cueCursor = timeline.seek(engine->remainingMs(timerId));
+    });
+    // Except zero itself: a change of time that reaches it plays it at once
+    connect(engine, &TimerEngine::zeroReached, this, [this](TimerEngine::TimerId id) {
+        if (id == timerId && changingTime) playCue(CueTimeline::Kind::Zero);
+    });
+
+    displayFont.setBold(true);
+    selectSegment(0);
+    engine->reset(timerId);
+    onTick(); // Show the start value
+    cuesLoadedMs = launchTimer.elapsed();
+}
+
+// Put playlist entry index on the clock and read its cues. WAV files are
+// small enough to read whole; there is nothing to decode.
+void MinimalWindow::selectSegment(int index) {
+    segmentIndex = index;
+    segment = config.segment(index);
+    qint64 startMs = segment.startMs();
+    qint64 limitMs = segment.limitMs();
+    engine->configure(timerId, startMs, limitMs);
+
+    TimeLayout layout = segment.format.layoutFor(startMs, limitMs);
+    texts.build(startMs, limitMs, layout, segment.format.overtime);
+    fontSizer = FontSizeResolver(displayFont,
+                                 widestCountdownText(startMs, limitMs, layout, segment.format.overtime));
+    displayFont.setPointSize(fontSizer.pointSizeFor(size()));
+
+    timeline = CueTimeline();
+    auto addCue = [this](qint64 atMs, CueTimeline::Kind kind, const QString &fileName) {
+        QString error;
+        CueTimeline::CueId cue = player.load(fileName, &error);
+        if (!error.isEmpty()) qWarning() << error;
+        timeline.add(atMs, kind, cue);
+    };
+    if (!segment.soundZeroFile.isEmpty()) addCue(0, CueTimeline::Kind::Zero, segment.soundZeroFile);
+    if (!segment.soundLimitFile.isEmpty()) addCue(limitMs, CueTimeline::Kind::Limit, segment.soundLimitFile);
+    for (const TimerWarning &warning : segment.warnings) {
+        addCue(warning.atMs, CueTimeline::Kind::Warning, warning.soundFile);
+    }
+
+    QString title = "Countdown Overtimer";
+    if (!segment.name.isEmpty()) title = segment.name + " - " + title;
+    setTitle(title);
+}
+
+void MinimalWindow::toggleRunning() {
+    if (engine->isRunning(timerId)) {
+        engine->pause(timerId);
+    } else {
+        engine->start(timerId);
+    }
+}
+
+// The engine reports a zero or limit these reach before returning, with
+// the cursor already past it
+void MinimalWindow::adjustTime(qint64 deltaMs) {
+    changingTime = true;
+    engine->adjust(timerId, deltaMs);
+    changingTime = false;
+}
+
+void MinimalWindow::seekTime(qint64 remainingMs) {
+    changingTime = true;
+    engine->seek(timerId, remainingMs);
+    changingTime = false;
+}
+
+void MinimalWindow::onTick() {
+    qint64 remainingMs = engine->remainingMs(timerId);
+    if (engine->isRunning(timerId)) playDueCues(remainingMs);
+
+    // Only repaint when the text or its colour actually changes
+    const QString &text = texts.text(remainingMs);
+    bool negative = remainingMs < 0;
+    if (text == shownText && negative == shownNegative) return;
+    shownText = text;
+    shownNegative = negative;
+    update();
+}
+
+void MinimalWindow::onLimitReached(TimerEngine::TimerId id) {
+    if (id != timerId) return;
+    // The limit cue, and anything else the last tick had not reached yet
+    if (changingTime) {
+        playCue(CueTimeline::Kind::Limit);
+    } else {
+        playDueCues(engine->remainingMs(timerId));
+    }
+
+    // A playlist carries straight on with its next segment
+    if (segmentIndex + 1 < config.segmentCount()) {
+        selectSegment(segmentIndex + 1);
+        engine->reset(timerId);
+        engine->start(timerId);
+    }
+}
+
+// Everything on the timeline the countdown has now reached; O(1) per tick
+// with nothing due
+void MinimalWindow::playDueCues(qint64 remainingMs) {
+    while (cueCursor < timeline.size() && timeline.at(cueCursor).atMs >= remainingMs) {
+        player.play(timeline.at(cueCursor).cue);
+        cueCursor++;
+    }
+}
+
+void MinimalWindow::playCue(CueTimeline::Kind kind) {
+    int index = timeline.indexOf(kind);
+    if (index >= 0) player.play(timeline.at(index).cue);
+}
+
+void MinimalWindow::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(QRect(QPoint(0, 0), size()), Qt::white);
+    painter.setFont(displayFont);
+    painter.setPen(shownNegative ? Qt::red : Qt::black);
+    painter.drawText(QRect(QPoint(0, 0), size()), Qt::AlignCenter, shownText);
+
+    if (painted) return;
+    painted = true;
+    if (measureStartup) {
+        // Same line as the full build, for side-by-side comparison; the
+        // cues were ready before the first paint
+        std::printf("first_paint_ms=%lld audio_ready_ms=%lld peak_rss_kb=%lld\n",
+                    static_cast<long long>(launchTimer.elapsed()),
+                    static_cast<long long>(cuesLoadedMs),
+                    static_cast<long long>(peakResidentKb()));
+        std::fflush(stdout);
+        QMetaObject::invokeMethod(qApp, &QCoreApplication::quit, Qt::QueuedConnection);
+    }
+}
+
+void MinimalWindow::resizeEvent(QResizeEvent *event) {
+    QRasterWindow::resizeEvent(event);
+    displayFont.setPointSize(fontSizer.pointSizeFor(size()));
+}
+
+void MinimalWindow::keyPressEvent(QKeyEvent *event) {
+    bool shift = event->modifiers() & Qt::ShiftModifier;
+    qint64 stepMs = shift ? 10 * 1000 : 60 * 1000;
+
+    if ((event->modifiers() & Qt::AltModifier)
+        && (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter)) {
+        if (windowStates() & Qt::WindowFullScreen) {
+            showNormal();
+        } else {
+            showFullScreen();
+        }
+        return;
+    }
+
+    switch (event->key()) {
+    case Qt::Key_Space:
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        toggleRunning();
+        break;
+    case Qt::Key_R:
+        // Like the full build's Reset: restart the segment, or the
+        // playlist once its last segment has finished
+        if (engine->state(timerId).limitReached && segmentIndex + 1 >= config.segmentCount()) {
+            selectSegment(0);
+        }
+        player.stop();
+        engine->reset(timerId);
+        onTick();
+        break;
+    case Qt::Key_Up: adjustTime(stepMs); break;
+    case Qt::Key_Down: adjustTime(-stepMs); break;
+    case Qt::Key_Plus: adjustTime(60 * 1000); break;
+    case Qt::Key_Minus: adjustTime(-60 * 1000); break;
+    case Qt::Key_Home: seekTime(segment.startMs()); break;
+    default:
+        QRasterWindow::keyPressEvent(event);
+        break;
+    }
+}
+
+void MinimalWindow::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) toggleRunning();
+    QRasterWindow::mouseReleaseEvent(event);
+}
@@ -0,0 +1,69 @@
+#ifndef MINIMALWINDOW_H
+#define MINIMALWINDOW_H
+
+#include <QElapsedTimer>
+#include <QFont>
+#include <QRasterWindow>
+#include <QString>
+
+#include "cuetimeline.h"
+#include "fontsizeresolver.h"
+#include "timeformat.h"
+#include "timerconfig.h"
+#include "timerengine.h"
+#include "wavcueplayer.h"
+
+// The whole display of the minimal kiosk build: one QRasterWindow that
+// paints the countdown text itself, with no widgets, no layouts and no
+// buttons. Space (or a click) starts and pauses, R resets, Alt+Enter
+// toggles fullscreen and Up/Down/+/-/Home adjust as in the full build.
+//
+// Cues come from the same CueTimeline as the full build, walked on the
+// GUI thread: the engine's per-second tick checks only the entry under
+// the cursor.
+class MinimalWindow : public QRasterWindow {
+    Q_OBJECT
+
+public:
+    MinimalWindow(const QElapsedTimer &launchTimer, bool measureStartup);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    QElapsedTimer launchTimer;
+    bool measureStartup;
+    qint64 cuesLoadedMs = -1;
+    bool painted = false;
+
+    TimerConfig config;
+    int segmentIndex = 0;
+    TimerSegment segment;
+    TimerEngine *engine;
+    TimerEngine::TimerId timerId;
+
+    CountdownTextTable texts;
+    QString shownText;
+    bool shownNegative = false;
+    QFont displayFont;
+    FontSizeResolver fontSizer;
+
+    WavCuePlayer player;
+    CueTimeline timeline;
+    int cueCursor = 0;
+    bool changingTime = false; // Inside adjustTime()/seekTime()
+
+    void selectSegment(int index);
+    void toggleRunning();
+    void adjustTime(qint64 deltaMs);
+    void seekTime(qint64 remainingMs);
+    void onTick();
+    void onLimitReached(TimerEngine::TimerId id);
+    void playDueCues(qint64 remainingMs);
+    void playCue(CueTimeline::Kind kind);
+};
+
+#endif // MINIMALWINDOW_H
@@ -0,0 +1,101 @@
+#include "mirrorwindow.h"
+
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScreen>
+
+void DisplayFeed::publish(const QString &text, bool negative, const QString &widestText) {
+    snapshot.text = text;
+    snapshot.negative = negative;
+    snapshot.widestText = widestText;
+    snapshot.version++;
+    emit changed();
+}
+
+void DisplayFeed::setViewing(bool viewing) {
+    viewers += viewing ? 1 : -1;
+    emit viewersChanged();
+}
+
+MirrorWindow::MirrorWindow(DisplayFeed *feed, QScreen *screen, QWidget *parent)
+    : QWidget(parent), feed(feed) {
+    setWindowTitle("Countdown Overtimer");
+    setAutoFillBackground(true);
+    setScreen(screen);
+    setGeometry(screen->geometry());
+
+    displayFont = font();
+    displayFont.setBold(true);
+
+    connect(feed, &DisplayFeed::changed, this, &MirrorWindow::onFeedChanged);
+}
+
+MirrorWindow::~MirrorWindow() {
+    if (viewing) feed->setViewing(false);
+}
+
+void MirrorWindow::onFeedChanged() {
+    // Qt folds any number of these into one paint on the next frame
+    if (viewing && feed->current().version != paintedVersion) update();
+}
+
+void MirrorWindow::paintEvent(QPaintEvent *) {
+    const DisplaySnapshot &snapshot = feed->current();
+    if (snapshot.widestText != sizedForText) {
+        sizedForText = snapshot.widestText;
+        fontSizer = FontSizeResolver(displayFont, sizedForText);
+        resizeFont();
+    }
+
+    QPainter painter(this);
+    painter.setFont(displayFont);
+    painter.setPen(snapshot.negative ? Qt::red : Qt::black);
+    painter.drawText(rect(), Qt::AlignCenter, snapshot.text);
+    paintedVersion = snapshot.version;
+}
+
+void MirrorWindow::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    resizeFont();
+}
+
+void MirrorWindow::resizeFont() {
+    displayFont.setPointSize(fontSizer.pointSizeFor(size()));
+}
+
+void MirrorWindow::keyPressEvent(QKeyEvent *event) {
+    if ((event->modifiers() & Qt::AltModifier)
+        && (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter)) {
+        if (isFullScreen()) {
+            showNormal();
+        } else {
+            showFullScreen();
+        }
+    } else {
+        QWidget::keyPressEvent(event);
+    }
+}
+
+void MirrorWindow::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    updateViewing();
+}
+
+void MirrorWindow::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    updateViewing();
+}
+
+void MirrorWindow::changeEvent(QEvent *event) {
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) updateViewing();
+}
+
+void MirrorWindow::updateViewing() {
+    bool nowViewing = isVisible() && !isMinimized();
+    if (nowViewing == viewing) return;
+    viewing = nowViewing;
+    feed->setViewing(viewing);
+    // Whatever changed while out of sight
+    if (viewing) update();
+}
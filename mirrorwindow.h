@@ -0,0 +1,79 @@
+#ifndef MIRRORWINDOW_H
+#define MIRRORWINDOW_H
+
+#include <QFont>
+#include <QObject>
+#include <QString>
+#include <QWidget>
+
+#include "fontsizeresolver.h"
+
+class QScreen;
+
+// What the main window shows right now, as one immutable value. The main
+// window formats each text once (from its interned tables) and publishes
+// it; mirrors only read the latest snapshot when they next paint, so extra
+// screens add a paint each but no formatting or engine work.
+struct DisplaySnapshot {
+    QString text;         // Shared with the main window's text table
+    QString widestText;   // What the font is sized for; changes with the layout
+    bool negative = false;
+    quint64 version = 0;  // Bumped on every publish
+};
+
+class DisplayFeed : public QObject {
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+
+    const DisplaySnapshot &current() const { return snapshot; }
+    void publish(const QString &text, bool negative, const QString &widestText);
+
+    // Whether any mirror can be seen; the main window keeps rendering
+    // while this is true even if it is itself minimised
+    bool hasViewers() const { return viewers > 0; }
+    void setViewing(bool viewing);
+
+signals:
+    void changed();
+    void viewersChanged();
+
+private:
+    DisplaySnapshot snapshot;
+    int viewers = 0;
+};
+
+// A full-screen copy of the main window's countdown for another screen
+// (a stage confidence monitor, say). It has no controls and no state of
+// its own; size and font follow its own screen.
+class MirrorWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    MirrorWindow(DisplayFeed *feed, QScreen *screen, QWidget *parent = nullptr);
+    ~MirrorWindow() override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    DisplayFeed *feed;
+    quint64 paintedVersion = 0;
+    bool viewing = false;
+
+    QFont displayFont;
+    QString sizedForText;
+    FontSizeResolver fontSizer;
+
+    void onFeedChanged();
+    void resizeFont();
+    void updateViewing();
+};
+
+#endif // MIRRORWINDOW_H
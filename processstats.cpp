@@ -0,0 +1,63 @@
+#include "processstats.h"
+
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+qint64 peakResidentKb() {
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return qint64(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef Q_OS_MACOS
+    return qint64(usage.ru_maxrss / 1024); // Bytes on macOS
+#else
+    return qint64(usage.ru_maxrss);
+#endif
+#endif
+}
+
+qint64 residentKb() {
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return qint64(counters.WorkingSetSize / 1024);
+#elif defined(Q_OS_LINUX)
+    // Second field of statm: resident pages
+    std::FILE *file = std::fopen("/proc/self/statm", "r");
+    if (!file) return -1;
+    long long size = 0;
+    long long pages = 0;
+    int read = std::fscanf(file, "%lld %lld", &size, &pages);
+    std::fclose(file);
+    if (read != 2) return -1;
+    return qint64(pages) * sysconf(_SC_PAGESIZE) / 1024;
+#else
+    return -1;
+#endif
+}
+
+void attachParentConsole() {
+#ifdef Q_OS_WIN
+    // Redirected (app > file, app | more): the C runtime already writes there
+    auto isRedirected = [](DWORD which) {
+        HANDLE handle = GetStdHandle(which);
+        return handle && handle != INVALID_HANDLE_VALUE && GetFileType(handle) != FILE_TYPE_UNKNOWN;
+    };
+    bool outRedirected = isRedirected(STD_OUTPUT_HANDLE);
+    bool errRedirected = isRedirected(STD_ERROR_HANDLE);
+    if (outRedirected && errRedirected) return;
+    if (!AttachConsole(ATTACH_PARENT_PROCESS)) return;
+    if (!outRedirected) std::freopen("CONOUT$", "w", stdout);
+    if (!errRedirected) std::freopen("CONOUT$", "w", stderr);
+#endif
+}
@@ -0,0 +1,19 @@
+#ifndef PROCESSSTATS_H
+#define PROCESSSTATS_H
+
+#include <QtGlobal>
+
+// Peak resident set size of this process so far, in KiB; -1 if the
+// platform does not say. For --measure-startup, to compare build profiles.
+qint64 peakResidentKb();
+// Resident set size right now, in KiB; -1 if the platform does not say
+qint64 residentKb();
+
+// Windows builds are WIN32 executables with no console of their own, so
+// --measure-startup's line and --headless output would be lost when run
+// from cmd or PowerShell. Attaches stdout and stderr to the parent's
+// console, each unless it is already redirected to a file or pipe. Does
+// nothing elsewhere.
+void attachParentConsole();
+
+#endif // PROCESSSTATS_H
@@ -0,0 +1,155 @@
+#include "sessionjournal.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QThread>
+#include <QTimer>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr qint64 RecordSize = sizeof(SessionJournal::Record);
+static_assert(RecordSize == 48, "Journal records are a fixed 48 bytes on disk");
+
+// Only these many bytes of a record are covered by its checksum
+constexpr qint64 ChecksummedSize = RecordSize - sizeof(quint32);
+
+} // namespace
+
+SessionJournal::SessionJournal(const QString &fileName, QObject *parent)
+    : QObject(parent), file(fileName) {
+    // One sync for however many transitions land in the same turn
+    // (a playlist switch is a limit, a reset and a start)
+    syncTimer = new QTimer(this);
+    syncTimer->setSingleShot(true);
+    syncTimer->setInterval(0);
+    connect(syncTimer, &QTimer::timeout, this, &SessionJournal::sync);
+}
+
+SessionJournal::~SessionJournal() {
+    if (syncThread) {
+        syncThread->quit();
+        syncThread->wait();
+    }
+    // Whatever was appended since the last sync, on this thread: the map
+    // is about to go
+    if (map && (syncTimer->isActive() || syncQueued)) flushToDisk();
+#ifdef Q_OS_WIN
+    if (syncHandle) CloseHandle(syncHandle);
+#endif
+    if (map) file.unmap(map);
+}
+
+bool SessionJournal::open() {
+    if (!file.open(QIODevice::ReadWrite)) return false;
+    const qint64 size = Capacity * RecordSize;
+    if (file.size() != size && !file.resize(size)) return false;
+    map = file.map(0, size);
+    if (!map) return false;
+#ifdef Q_OS_WIN
+    // A QFile opened by name has no CRT descriptor to get a HANDLE from, so
+    // open a second handle just for FlushFileBuffers
+    HANDLE handle = CreateFileW(
+        reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(file.fileName()).utf16()),
+        GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle != INVALID_HANDLE_VALUE) syncHandle = handle;
+#endif
+
+    syncThread = new QThread(this);
+    syncThread->setObjectName("SessionJournal");
+    syncer = new QObject;
+    syncer->moveToThread(syncThread);
+    connect(syncThread, &QThread::finished, syncer, &QObject::deleteLater);
+    syncThread->start();
+
+    // Bounded by Capacity, not by how long the session ran
+    for (int i = 0; i < Capacity; ++i) {
+        Record record;
+        std::memcpy(&record, map + i * RecordSize, RecordSize);
+        if (record.checksum != checksumOf(record)) continue;
+        if (!haveLast || record.sequence > lastRecord.sequence) {
+            lastRecord = record;
+            haveLast = true;
+        }
+    }
+    nextSequence = haveLast ? lastRecord.sequence + 1 : 1;
+    return true;
+}
+
+void SessionJournal::append(Event event, const CountdownState &state, qint64 remainingMs,
+                            int segment) {
+    if (!map) return;
+
+    Record record;
+    record.sequence = nextSequence++;
+    record.event = event;
+    record.flags = (state.isRunning ? Running : 0) | (state.isPaused ? Paused : 0)
+                   | (state.zeroSoundPlayed ? ZeroPlayed : 0)
+                   | (state.limitReached ? LimitHit : 0);
+    record.segment = quint16(segment);
+    record.wallMs = QDateTime::currentMSecsSinceEpoch();
+    record.remainingMs = remainingMs;
+    record.startMs = state.startMs;
+    record.limitMs = state.limitMs;
+    record.checksum = checksumOf(record);
+
+    // The ring overwrites the oldest record; only the latest is ever needed
+    std::memcpy(map + (record.sequence % Capacity) * RecordSize, &record, RecordSize);
+    if (!syncTimer->isActive()) syncTimer->start();
+}
+
+CountdownState SessionJournal::stateAt(const Record &record, qint64 nowWallMs) {
+    CountdownState state;
+    state.startMs = record.startMs;
+    state.limitMs = record.limitMs;
+    state.currentMs = record.remainingMs;
+    state.isRunning = record.flags & Running;
+    state.isPaused = record.flags & Paused;
+    state.zeroSoundPlayed = record.flags & ZeroPlayed;
+    state.limitReached = record.flags & LimitHit;
+
+    if (state.isRunning) {
+        state.currentMs -= qMax<qint64>(0, nowWallMs - record.wallMs);
+        if (state.currentMs <= 0) state.zeroSoundPlayed = true;
+    }
+    return state;
+}
+
+// FNV-1a; enough to tell a torn or never-written record from a real one
+quint32 SessionJournal::checksumOf(const Record &record) {
+    const uchar *bytes = reinterpret_cast<const uchar *>(&record);
+    quint32 hash = 2166136261u;
+    for (qint64 i = 0; i < ChecksummedSize; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Hands the flush to the sync thread. One queued flush covers every append
+// made before it starts, so a transition during a slow flush queues at
+// most one more.
+void SessionJournal::sync() {
+    syncTimer->stop();
+    if (syncQueued.exchange(true)) return;
+    QMetaObject::invokeMethod(syncer, [this]() {
+        syncQueued = false;
+        flushToDisk();
+    }, Qt::QueuedConnection);
+}
+
+void SessionJournal::flushToDisk() {
+    const qint64 size = Capacity * RecordSize;
+#ifdef Q_OS_WIN
+    FlushViewOfFile(map, size_t(size));
+    if (syncHandle) FlushFileBuffers(syncHandle);
+#else
+    msync(map, size_t(size), MS_SYNC);
+#endif
+}
@@ -0,0 +1,92 @@
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <atomic>
+
+#include "timerengine.h"
+
+class QThread;
+class QTimer;
+
+// Append-only record of one timer's state transitions, so a crash or a
+// reboot mid-session resumes the countdown where it was instead of at the
+// start value.
+//
+// The file is a fixed ring of Capacity checksummed records, memory-mapped
+// once in open(). Appending is a copy into the map; the sync to disk runs
+// once per event-loop turn that appended anything, never per tick, and on
+// a thread of its own so the GUI thread never waits for the disk. A torn
+// write only damages the record being written, so the one before it is
+// what comes back.
+class SessionJournal : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Event : quint8 {
+        Started,     // Also a running timer's time being changed (adjust)
+        Paused,
+        Reset,
+        ZeroReached,
+        LimitReached
+    };
+
+    enum Flag : quint8 {
+        Running = 0x01,
+        Paused = 0x02,
+        ZeroPlayed = 0x04,
+        LimitHit = 0x08
+    };
+
+    struct Record {
+        quint32 sequence = 0;  // Consecutive; the highest valid one is the latest
+        Event event = Event::Reset;
+        quint8 flags = 0;      // Flag bits
+        quint16 segment = 0;   // Playlist position
+        qint64 wallMs = 0;     // Wall-clock time of the transition (ms since epoch)
+        qint64 remainingMs = 0;
+        qint64 startMs = 0;
+        qint64 limitMs = 0;
+        quint32 reserved = 0;
+        quint32 checksum = 0;  // Over everything above
+    };
+
+    static constexpr int Capacity = 1024;
+
+    explicit SessionJournal(const QString &fileName, QObject *parent = nullptr);
+    ~SessionJournal() override;
+
+    // Maps the file (creating it if needed) and finds the latest record.
+    // Returns false if the journal cannot be used at all.
+    bool open();
+    // The latest intact record from before open(), if there was one
+    bool hasLast() const { return haveLast; }
+    Record last() const { return lastRecord; }
+
+    void append(Event event, const CountdownState &state, qint64 remainingMs, int segment);
+
+    // The state a record describes, carried forward to nowWallMs as if a
+    // running timer had kept counting. A zero crossing that happened in
+    // the meantime counts as played: a cue that late is no use.
+    static CountdownState stateAt(const Record &record, qint64 nowWallMs);
+
+private:
+    QFile file;
+    uchar *map = nullptr;
+    quint32 nextSequence = 0;
+    bool haveLast = false;
+    Record lastRecord;
+    QTimer *syncTimer;
+    QThread *syncThread = nullptr;
+    QObject *syncer = nullptr; // Lives on syncThread
+    std::atomic<bool> syncQueued{false};
+    void *syncHandle = nullptr; // Windows only: a handle FlushFileBuffers accepts
+
+    static quint32 checksumOf(const Record &record);
+    void sync();
+    void flushToDisk();
+};
+
+#endif // SESSIONJOURNAL_H
@@ -0,0 +1,45 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer queue for handing small values
+// between two threads without a lock. One thread only ever push()es and
+// one other thread only ever pop()s; neither call blocks or allocates.
+// A full queue rejects the push, so a flood on one side can never stall
+// the other.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T &value) {
+        std::size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) == Capacity) return false;
+        items[tail & (Capacity - 1)] = value;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T *value) {
+        std::size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire)) return false;
+        *value = items[head & (Capacity - 1)];
+        readIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const {
+        return readIndex.load(std::memory_order_acquire)
+               == writeIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    T items[Capacity];
+    // On separate cache lines so producer and consumer don't contend
+    alignas(64) std::atomic<std::size_t> writeIndex{0};
+    alignas(64) std::atomic<std::size_t> readIndex{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,261 @@
+#include "statebroadcast.h"
+
+#include <QNetworkDatagram>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <cstring>
+
+#include "timesync.h"
+
+namespace StateWire {
+
+namespace {
+
+const char Magic[4] = { 'C', 'D', 'O', 'T' };
+const char SyncMagic[4] = { 'C', 'D', 'T', 'S' };
+constexpr quint8 WireVersion = 2;
+
+} // namespace
+
+// Layout (big-endian):
+//   0  magic "CDOT"     4  wire version     5  flags      6  timer index (u16)
+//   8  session (u32)   12  version (u32)
+//  16  senderNowMs     24  remainingMs      32  limitMs   40  startMs  (i64 each)
+//  48  segment (u16)   50  reserved
+QByteArray encode(const Packet &packet) {
+    QByteArray data(PacketSize, '\0');
+    uchar *p = reinterpret_cast<uchar *>(data.data());
+    std::memcpy(p, Magic, 4);
+    p[4] = WireVersion;
+    p[5] = packet.flags;
+    qToBigEndian<quint16>(packet.timer, p + 6);
+    qToBigEndian<quint32>(packet.session, p + 8);
+    qToBigEndian<quint32>(packet.version, p + 12);
+    qToBigEndian<qint64>(packet.senderNowMs, p + 16);
+    qToBigEndian<qint64>(packet.remainingMs, p + 24);
+    qToBigEndian<qint64>(packet.limitMs, p + 32);
+    qToBigEndian<qint64>(packet.startMs, p + 40);
+    qToBigEndian<quint16>(packet.segment, p + 48);
+    return data;
+}
+
+bool decode(const QByteArray &data, Packet *packet) {
+    if (data.size() != PacketSize) return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (std::memcmp(p, Magic, 4) != 0 || p[4] != WireVersion) return false;
+
+    packet->flags = p[5];
+    packet->timer = qFromBigEndian<quint16>(p + 6);
+    packet->session = qFromBigEndian<quint32>(p + 8);
+    packet->version = qFromBigEndian<quint32>(p + 12);
+    packet->senderNowMs = qFromBigEndian<qint64>(p + 16);
+    packet->remainingMs = qFromBigEndian<qint64>(p + 24);
+    packet->limitMs = qFromBigEndian<qint64>(p + 32);
+    packet->startMs = qFromBigEndian<qint64>(p + 40);
+    packet->segment = qFromBigEndian<quint16>(p + 48);
+    return true;
+}
+
+// Layout (big-endian):
+//   0  magic "CDTS"     4  wire version     5  1 for a reply, else 0
+//   6  generation (u16)
+//   8  requestSentUs   16  requestReceivedUs   24  replySentUs  (i64 each)
+QByteArray encodeSync(const SyncPacket &packet) {
+    QByteArray data(SyncPacketSize, '\0');
+    uchar *p = reinterpret_cast<uchar *>(data.data());
+    std::memcpy(p, SyncMagic, 4);
+    p[4] = WireVersion;
+    p[5] = packet.reply ? 1 : 0;
+    qToBigEndian<quint16>(packet.generation, p + 6);
+    qToBigEndian<qint64>(packet.requestSentUs, p + 8);
+    qToBigEndian<qint64>(packet.requestReceivedUs, p + 16);
+    qToBigEndian<qint64>(packet.replySentUs, p + 24);
+    return data;
+}
+
+bool decodeSync(const QByteArray &data, SyncPacket *packet) {
+    if (data.size() != SyncPacketSize) return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (std::memcmp(p, SyncMagic, 4) != 0 || p[4] != WireVersion) return false;
+
+    packet->reply = p[5] == 1;
+    packet->generation = qFromBigEndian<quint16>(p + 6);
+    packet->requestSentUs = qFromBigEndian<qint64>(p + 8);
+    packet->requestReceivedUs = qFromBigEndian<qint64>(p + 16);
+    packet->replySentUs = qFromBigEndian<qint64>(p + 24);
+    return true;
+}
+
+bool parseEndpoint(const QString &text, QHostAddress *group, quint16 *port) {
+    QString host = text;
+    *port = DefaultPort;
+
+    int colon = text.lastIndexOf(':');
+    if (colon >= 0) {
+        host = text.left(colon);
+        bool ok = false;
+        *port = text.mid(colon + 1).toUShort(&ok);
+        if (!ok || *port == 0) return false;
+    }
+
+    if (host.isEmpty()) host = QString::fromLatin1(DefaultGroup);
+    return group->setAddress(host) && group->isMulticast();
+}
+
+} // namespace StateWire
+
+namespace {
+
+const char PublisherSocketName[] = "StatePublisherSocket";
+
+void answerSyncRequests(QUdpSocket *socket, const CountdownClock &clock) {
+    while (socket->hasPendingDatagrams()) {
+        QNetworkDatagram datagram = socket->receiveDatagram();
+        qint64 receivedUs = clock.nowUs();
+        StateWire::SyncPacket packet;
+        if (!StateWire::decodeSync(datagram.data(), &packet) || packet.reply) continue;
+
+        packet.reply = true;
+        packet.requestReceivedUs = receivedUs;
+        packet.replySentUs = clock.nowUs();
+        socket->writeDatagram(StateWire::encodeSync(packet), datagram.senderAddress(),
+                              quint16(datagram.senderPort()));
+    }
+}
+
+// Every publisher on one engine sends from the same socket with the same
+// session. Sync is to the engine's clock, so a follower must see a single
+// server whichever of its timers it hears; with a socket per publisher,
+// --timers N would keep resetting it. Owned by the engine, made by the
+// first publisher.
+QUdpSocket *publisherSocket(TimerEngine *engine) {
+    auto *socket = engine->findChild<QUdpSocket *>(PublisherSocketName, Qt::FindDirectChildrenOnly);
+    if (socket) return socket;
+
+    socket = new QUdpSocket(engine);
+    socket->setObjectName(PublisherSocketName);
+    socket->setProperty("session", QRandomGenerator::global()->generate());
+    // Bound up front, so sync requests sent back to where the state
+    // packets come from arrive here
+    socket->bind(QHostAddress::AnyIPv4, 0);
+    socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1); // Stay on the local network
+    QObject::connect(socket, &QUdpSocket::readyRead, socket,
+                     [socket, engine]() { answerSyncRequests(socket, engine->clock()); });
+    return socket;
+}
+
+} // namespace
+
+StatePublisher::StatePublisher(TimerEngine *engine, TimerEngine::TimerId timerId,
+                               const QHostAddress &group, quint16 port, QObject *parent)
+    : QObject(parent), engine(engine), timerId(timerId), group(group), port(port) {
+    socket = publisherSocket(engine);
+    session = socket->property("session").toUInt();
+
+    heartbeat = new QTimer(this);
+    heartbeat->setInterval(HeartbeatMs);
+    heartbeat->setTimerType(Qt::VeryCoarseTimer);
+    connect(heartbeat, &QTimer::timeout, this, &StatePublisher::publish);
+    heartbeat->start();
+
+    connect(engine, &TimerEngine::stateChanged, this, [this](TimerEngine::TimerId id) {
+        if (id != this->timerId) return;
+        version++;
+        publish();
+        heartbeat->start(); // Next repeat a full period after this change
+    });
+
+    publish();
+}
+
+void StatePublisher::publish() {
+    CountdownState state = engine->state(timerId);
+    qint64 now = engine->clock().nowMs();
+
+    StateWire::Packet packet;
+    packet.session = session;
+    packet.version = version;
+    packet.timer = quint16(timerId);
+    packet.senderNowMs = now;
+    packet.remainingMs = engine->remainingAt(timerId, now);
+    packet.limitMs = state.limitMs;
+    packet.startMs = state.startMs;
+    packet.segment = segment;
+    if (state.isRunning) packet.flags |= StateWire::Running;
+    if (state.isPaused) packet.flags |= StateWire::Paused;
+    if (state.zeroSoundPlayed) packet.flags |= StateWire::ZeroPlayed;
+    if (state.limitReached) packet.flags |= StateWire::LimitHit;
+
+    socket->writeDatagram(StateWire::encode(packet), group, port);
+}
+
+StateFollower::StateFollower(TimerEngine *engine, TimerEngine::TimerId timerId,
+                             const QHostAddress &group, quint16 port, QObject *parent)
+    : QObject(parent), engine(engine), timerId(timerId) {
+    socket = new QUdpSocket(this);
+    listening = socket->bind(QHostAddress::AnyIPv4, port,
+                             QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)
+                && socket->joinMulticastGroup(group);
+    connect(socket, &QUdpSocket::readyRead, this, &StateFollower::readPending);
+}
+
+void StateFollower::readPending() {
+    while (socket->hasPendingDatagrams()) {
+        QNetworkDatagram datagram = socket->receiveDatagram();
+        StateWire::Packet packet;
+        if (StateWire::decode(datagram.data(), &packet) && packet.timer == timerId) {
+            // A new session is a restarted publisher, on a new timeline
+            if (timeSync) {
+                timeSync->follow(datagram.senderAddress(), quint16(datagram.senderPort()),
+                                 packet.session);
+            }
+            apply(packet);
+        }
+    }
+}
+
+void StateFollower::apply(const StateWire::Packet &packet) {
+    // Heartbeats included, so a follower that missed the change catches up
+    if (packet.segment != segment) {
+        segment = packet.segment;
+        emit segmentChanged(segment);
+    }
+
+    bool isNew = !hasState || packet.session != session || packet.version != version;
+
+    if (!isNew) {
+        // Heartbeat for a state we already follow: only correct real drift,
+        // otherwise network jitter would nudge the display back and forth.
+        if (!(packet.flags & StateWire::Running)) return;
+        qint64 drift = engine->remainingAt(timerId, engine->clock().nowMs()) - remainingNow(packet);
+        bool synced = timeSync && timeSync->isSynced();
+        if (qAbs(drift) <= (synced ? MaxSyncedDriftMs : MaxDriftMs)) return;
+    }
+
+    hasState = true;
+    session = packet.session;
+    version = packet.version;
+
+    CountdownState state;
+    state.startMs = packet.startMs;
+    state.limitMs = packet.limitMs;
+    state.currentMs = remainingNow(packet);
+    state.isRunning = packet.flags & StateWire::Running;
+    state.isPaused = packet.flags & StateWire::Paused;
+    state.zeroSoundPlayed = packet.flags & StateWire::ZeroPlayed;
+    state.limitReached = packet.flags & StateWire::LimitHit;
+    engine->applySnapshot(timerId, state);
+}
+
+qint64 StateFollower::remainingNow(const StateWire::Packet &packet) const {
+    if (!(packet.flags & StateWire::Running) || !timeSync || !timeSync->isSynced()) {
+        // Taken as sent just now: the one-way delay shows as lag
+        return packet.remainingMs;
+    }
+    // Both ends count on the same timeline now
+    return packet.remainingMs - (engine->clock().nowMs() - packet.senderNowMs);
+}
@@ -0,0 +1,142 @@
+#ifndef STATEBROADCAST_H
+#define STATEBROADCAST_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+
+#include "timerengine.h"
+
+class QTimer;
+class QUdpSocket;
+
+// Mirrors one countdown onto any number of screens over UDP multicast.
+//
+// The publisher sends a fixed-size binary packet whenever the timer's state
+// changes (start, pause, reset, limit) and repeats it every few seconds for
+// screens that join late. It never sends per tick. Followers re-anchor
+// their own engine on the remaining time in the packet and count down
+// locally, so traffic stays the same whatever the tick rate and screen count.
+namespace StateWire {
+
+constexpr quint16 DefaultPort = 45454;
+constexpr const char *DefaultGroup = "239.255.67.68";
+
+enum Flag : quint8 {
+    Running = 0x01,
+    Paused = 0x02,
+    ZeroPlayed = 0x04,
+    LimitHit = 0x08
+};
+
+struct Packet {
+    quint32 session = 0;     // Random per publishing engine; a new value resets followers
+    quint32 version = 0;     // Bumped on every state change, repeated by heartbeats
+    quint16 timer = 0;       // Timer index, for publishers driving several timers
+    quint8 flags = 0;
+    qint64 senderNowMs = 0;  // Publisher's clock when the packet was built
+    qint64 remainingMs = 0;  // Remaining time at senderNowMs
+    qint64 limitMs = 0;
+    qint64 startMs = 0;
+    quint16 segment = 0;     // Playlist position the timer is on
+};
+
+constexpr int PacketSize = 52;
+
+QByteArray encode(const Packet &packet);
+bool decode(const QByteArray &data, Packet *packet);
+
+// Time-sync exchange between a follower and the publisher it hears, sent
+// unicast to the address and port the state packets come from. All
+// times are microseconds, each on its own machine's engine clock.
+struct SyncPacket {
+    bool reply = false;
+    quint16 generation = 0;      // Follower's clock generation, echoed back
+    qint64 requestSentUs = 0;    // Follower, echoed back in the reply
+    qint64 requestReceivedUs = 0; // Publisher
+    qint64 replySentUs = 0;      // Publisher
+};
+
+constexpr int SyncPacketSize = 32;
+
+QByteArray encodeSync(const SyncPacket &packet);
+bool decodeSync(const QByteArray &data, SyncPacket *packet);
+
+// Parses "group:port", "group" or "" into a multicast endpoint
+bool parseEndpoint(const QString &text, QHostAddress *group, quint16 *port);
+
+} // namespace StateWire
+
+// Besides the multicast state, answers time-sync requests on the same
+// socket, so followers can put their clocks on this engine's timeline.
+// All publishers on one engine share that socket and their session.
+class StatePublisher : public QObject {
+    Q_OBJECT
+
+public:
+    StatePublisher(TimerEngine *engine, TimerEngine::TimerId timerId,
+                   const QHostAddress &group, quint16 port, QObject *parent = nullptr);
+
+    // The playlist position, sent from the next packet on (state change or
+    // heartbeat); set it before the engine change that starts the segment
+    void setSegment(int index) { segment = quint16(index); }
+
+private:
+    static constexpr int HeartbeatMs = 2000;
+
+    TimerEngine *engine;
+    TimerEngine::TimerId timerId;
+    QHostAddress group;
+    quint16 port;
+    QUdpSocket *socket; // The engine's, shared with its other publishers
+    QTimer *heartbeat;
+    quint32 session;
+    quint32 version = 0;
+    quint16 segment = 0;
+
+    void publish();
+};
+
+class TimeSyncClient;
+
+class StateFollower : public QObject {
+    Q_OBJECT
+
+public:
+    StateFollower(TimerEngine *engine, TimerEngine::TimerId timerId,
+                  const QHostAddress &group, quint16 port, QObject *parent = nullptr);
+
+    bool isListening() const { return listening; }
+
+    // Once sync has put the engine's clock on the publisher's timeline,
+    // packets are taken at the time they were sent rather than received
+    void setTimeSync(TimeSyncClient *sync) { timeSync = sync; }
+
+signals:
+    // The publisher is on another playlist segment. Emitted before the
+    // state that goes with it is applied.
+    void segmentChanged(int index);
+
+private:
+    // Heartbeats only re-anchor a running timer that has drifted this far;
+    // much less once clocks are synced and drift is real, not jitter
+    static constexpr qint64 MaxDriftMs = 20;
+    static constexpr qint64 MaxSyncedDriftMs = 2;
+
+    TimerEngine *engine;
+    TimerEngine::TimerId timerId;
+    QUdpSocket *socket;
+    bool listening = false;
+    bool hasState = false;
+    quint32 session = 0;
+    quint32 version = 0;
+    int segment = -1;
+    TimeSyncClient *timeSync = nullptr;
+
+    void readPending();
+    void apply(const StateWire::Packet &packet);
+    // Remaining time the packet implies for right now
+    qint64 remainingNow(const StateWire::Packet &packet) const;
+};
+
+#endif // STATEBROADCAST_H
@@ -0,0 +1,50 @@
+#include "tickscheduler.h"
+
+#include <cmath>
+
+TickScheduler::TickScheduler(QObject *parent) : QObject(parent) {
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &TickScheduler::onTimeout);
+}
+
+void TickScheduler::setMode(Mode mode) {
+    if (mode == currentMode) return;
+    currentMode = mode;
+
+    // Takes effect on the next armForRemaining(); the caller re-arms
+    // straight away when the window comes back so nothing is missed.
+    timer->setTimerType(mode == Mode::Precise ? Qt::PreciseTimer : Qt::CoarseTimer);
+}
+
+void TickScheduler::armForRemaining(qint64 remainingMs) {
+    armIn(msUntilNextSecond(remainingMs));
+}
+
+void TickScheduler::armIn(qint64 delayMs) {
+    armedDelayMs = qMax<qint64>(delayMs, 0);
+    armedAt.start();
+    timer->start(int(armedDelayMs));
+}
+
+void TickScheduler::onTimeout() {
+    // One clock read per tick; cheap enough to leave on unconditionally
+    latenessUs = armedAt.nsecsElapsed() / 1000 - armedDelayMs * 1000;
+    emit tick();
+}
+
+void TickScheduler::stop() {
+    timer->stop();
+}
+
+qint64 TickScheduler::msUntilNextSecond(qint64 remainingMs) {
+    // updateDisplay() truncates |remainingMs| to whole seconds, so:
+    //  - counting down to zero, "39" lasts until remainingMs drops below 39000
+    //  - past zero, "-39" lasts until remainingMs reaches -40000
+    qint64 absMs = std::abs(remainingMs);
+    if (remainingMs >= 0) {
+        return (absMs % 1000) + 1;
+    }
+    return 1000 - (absMs % 1000);
+}
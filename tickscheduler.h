@@ -0,0 +1,51 @@
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// Drives the countdown by arming one single-shot timer per displayed second
+// instead of polling. Each tick is aimed at the moment the whole-second part
+// of the remaining time changes, so the display turns over on the boundary
+// while the process only wakes up about once a second.
+class TickScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Precise, // Visible window: Qt::PreciseTimer, fires on the boundary millisecond
+        Coarse   // Minimised/hidden window: Qt::CoarseTimer, lets the OS batch wakeups
+    };
+
+    explicit TickScheduler(QObject *parent = nullptr);
+
+    void setMode(Mode mode);
+    Mode mode() const { return currentMode; }
+
+    // Arm the next tick for when the displayed second of remainingMs changes.
+    void armForRemaining(qint64 remainingMs);
+    // Arm the next tick delayMs from now (for callers that merge several deadlines).
+    void armIn(qint64 delayMs);
+    void stop();
+    bool isActive() const { return timer->isActive(); }
+    // How late the last tick fired relative to when it was due, in us
+    qint64 lastLatenessUs() const { return latenessUs; }
+
+    // Milliseconds until the mm:ss text for remainingMs changes (always >= 1).
+    static qint64 msUntilNextSecond(qint64 remainingMs);
+
+signals:
+    void tick();
+
+private:
+    Mode currentMode = Mode::Precise;
+    QTimer *timer;
+    QElapsedTimer armedAt;
+    qint64 armedDelayMs = 0;
+    qint64 latenessUs = 0;
+
+    void onTimeout();
+};
+
+#endif // TICKSCHEDULER_H
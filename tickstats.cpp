@@ -0,0 +1,85 @@
+#include "tickstats.h"
+
+#include <QDateTime>
+#include <QSaveFile>
+#include <QStringList>
+#include <algorithm>
+
+TickStats::TickStats() : startedAtMs(QDateTime::currentMSecsSinceEpoch()) {
+    for (Ring &ring : rings) {
+        ring.samples.resize(Capacity);
+    }
+}
+
+void TickStats::record(Series series, qint64 valueUs) {
+    Ring &ring = rings[series];
+    Sample &sample = ring.samples[ring.next];
+    sample.atMs = QDateTime::currentMSecsSinceEpoch() - startedAtMs;
+    sample.valueUs = valueUs;
+    ring.next = (ring.next + 1) % Capacity;
+    ring.count = qMin(ring.count + 1, Capacity);
+}
+
+TickStats::Summary TickStats::summary(Series series) const {
+    const Ring &ring = rings[series];
+    Summary result;
+    result.count = ring.count;
+    if (ring.count == 0) return result;
+
+    QVector<qint64> values;
+    values.reserve(ring.count);
+    for (int i = 0; i < ring.count; ++i) {
+        values.append(ring.samples[i].valueUs);
+    }
+    std::sort(values.begin(), values.end());
+    result.p50Us = values[(ring.count - 1) / 2];
+    result.p99Us = values[(ring.count - 1) * 99 / 100];
+    result.maxUs = values.last();
+    return result;
+}
+
+QString TickStats::summaryText() const {
+    auto ms = [](qint64 us) { return QString::number(us / 1000.0, 'f', 2); };
+
+    QStringList lines;
+    for (int i = 0; i < SeriesCount; ++i) {
+        Series series = Series(i);
+        Summary s = summary(series);
+        lines.append(QString("%1  p50 %2  p99 %3  max %4 ms  (n=%5)")
+                         .arg(QString(seriesName(series)).leftJustified(6))
+                         .arg(ms(s.p50Us), ms(s.p99Us), ms(s.maxUs))
+                         .arg(s.count));
+    }
+    return lines.join('\n');
+}
+
+bool TickStats::writeCsv(const QString &fileName) const {
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    file.write("series,time_ms,value_us\n");
+    for (int i = 0; i < SeriesCount; ++i) {
+        const Ring &ring = rings[i];
+        // Oldest first: a full ring starts at its write position
+        int first = ring.count < Capacity ? 0 : ring.next;
+        for (int n = 0; n < ring.count; ++n) {
+            const Sample &sample = ring.samples[(first + n) % Capacity];
+            file.write(QString("%1,%2,%3\n")
+                           .arg(seriesName(Series(i)))
+                           .arg(sample.atMs)
+                           .arg(sample.valueUs)
+                           .toLatin1());
+        }
+    }
+    return file.commit();
+}
+
+const char *TickStats::seriesName(Series series) {
+    switch (series) {
+    case TickLateness: return "tick";
+    case UpdateDuration: return "update";
+    case PaintDuration: return "paint";
+    case CueLateness: return "cue";
+    default: return "?";
+    }
+}
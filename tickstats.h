@@ -0,0 +1,58 @@
+#ifndef TICKSTATS_H
+#define TICKSTATS_H
+
+#include <QString>
+#include <QVector>
+
+// Fixed-size ring buffers of timing samples behind the Alt+J overlay.
+// Recording is a store and an index bump; sorting for percentiles only
+// happens when the overlay asks for a summary. The owner creates one only
+// while measuring, so a normal run pays nothing but a null check.
+class TickStats {
+public:
+    enum Series {
+        TickLateness,   // Actual minus scheduled tick time
+        UpdateDuration, // Time spent in updateDisplay()
+        PaintDuration,  // Time to repaint the window
+        CueLateness,    // Cue trigger minus its deadline, on the cue thread
+        SeriesCount
+    };
+
+    struct Summary {
+        int count = 0;
+        qint64 p50Us = 0;
+        qint64 p99Us = 0;
+        qint64 maxUs = 0;
+    };
+
+    static constexpr int Capacity = 1024; // Samples kept per series
+
+    TickStats();
+
+    void record(Series series, qint64 valueUs);
+    Summary summary(Series series) const;
+    // Multi-line "p50/p99/max" text for the overlay
+    QString summaryText() const;
+
+    // Writes every buffered sample as "series,time_ms,value_us"
+    bool writeCsv(const QString &fileName) const;
+
+    static const char *seriesName(Series series);
+
+private:
+    struct Sample {
+        qint64 atMs = 0;  // Milliseconds since recording started
+        qint64 valueUs = 0;
+    };
+
+    struct Ring {
+        QVector<Sample> samples;
+        int next = 0;
+        int count = 0;
+    };
+
+    qint64 startedAtMs;
+    Ring rings[SeriesCount];
+};
+
+#endif // TICKSTATS_H
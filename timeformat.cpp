@@ -0,0 +1,44 @@
+#include "timeformat.h"
+
+qint64 CountdownTextTable::slotFor(qint64 ms) const {
+    if (ms >= 0) return ms / step;
+    return -(-ms / step) - 1;
+}
+
+void CountdownTextTable::build(qint64 startMs, qint64 limitMs, TimeLayout layout,
+                               OvertimeSign sign) {
+    bool sameFormat = layout == tableLayout && sign == tableSign;
+    tableLayout = layout;
+    tableSign = sign;
+    formatter = TimeFormat::formatterFor(layout, sign);
+    step = TimeFormat::stepMs(layout);
+    qint64 first = slotFor(qMin(startMs, limitMs));
+    qint64 last = slotFor(qMax(startMs, limitMs));
+    if (sameFormat && first == firstSlot && last - first + 1 == texts.size()) {
+        return;
+    }
+
+    firstSlot = first;
+    texts.clear();
+    if (last - first + 1 > MaxEntries) return;
+
+    // Any millisecond value inside a slot formats the same; use the one
+    // nearest zero so truncation lands on the slot itself
+    char16_t buffer[TimeFormat::MaxLength];
+    texts.reserve(int(last - first + 1));
+    for (qint64 slot = first; slot <= last; ++slot) {
+        qint64 ms = slot >= 0 ? slot * step : (slot + 1) * step - 1;
+        int length = formatter(buffer, ms);
+        texts.append(QString(reinterpret_cast<const QChar *>(buffer), length));
+    }
+}
+
+const QString &CountdownTextTable::text(qint64 ms) {
+    qint64 index = slotFor(ms) - firstSlot;
+    if (index >= 0 && index < texts.size()) return texts[int(index)];
+
+    char16_t buffer[TimeFormat::MaxLength];
+    int length = formatter(buffer, ms);
+    fallback = QString(reinterpret_cast<const QChar *>(buffer), length);
+    return fallback;
+}
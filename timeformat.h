@@ -0,0 +1,244 @@
+#ifndef TIMEFORMAT_H
+#define TIMEFORMAT_H
+
+#include <QString>
+#include <QVector>
+
+// How a countdown value is written out
+enum class TimeLayout {
+    MinutesSeconds,       // "mm:ss"; minutes grow past 99 if needed
+    HoursMinutesSeconds,  // "h:mm:ss", for sessions of an hour or more
+    MinutesSecondsTenths, // "mm:ss.t", for the final seconds
+    SecondsTenths         // "ss.t"; seconds grow past 99 if needed
+};
+
+// The sign in front of a value past zero
+enum class OvertimeSign {
+    Minus, // "-05:00"
+    Plus   // "+05:00": time over, rather than time left
+};
+
+namespace TimeFormat {
+
+// "00" to "99" as UTF-16: the pair for n is at [2n] and [2n + 1]
+struct DigitPairs {
+    char16_t chars[200];
+    constexpr DigitPairs() : chars{} {
+        for (int n = 0; n < 100; ++n) {
+            chars[2 * n] = char16_t(u'0' + n / 10);
+            chars[2 * n + 1] = char16_t(u'0' + n % 10);
+        }
+    }
+};
+inline constexpr DigitPairs digitPairs{};
+
+// Longest possible output, sign and all
+constexpr int MaxLength = 32;
+
+inline char16_t *writeTwoDigits(char16_t *out, int value) {
+    out[0] = digitPairs.chars[2 * value];
+    out[1] = digitPairs.chars[2 * value + 1];
+    return out + 2;
+}
+
+// At least two digits, more if the value needs them
+inline char16_t *writeNumber(char16_t *out, qint64 value) {
+    if (value < 100) return writeTwoDigits(out, int(value));
+
+    char16_t reversed[20];
+    int count = 0;
+    while (value > 0) {
+        reversed[count++] = char16_t(u'0' + value % 10);
+        value /= 10;
+    }
+    while (count > 0) *out++ = reversed[--count];
+    return out;
+}
+
+// One specialisation per layout, with its digits and step fixed at compile
+// time. write() gets the absolute value and truncates the last unit shown,
+// matching how the countdown turns over.
+template <TimeLayout Layout>
+struct Spec;
+
+template <>
+struct Spec<TimeLayout::MinutesSeconds> {
+    static constexpr qint64 StepMs = 1000;
+    static char16_t *write(char16_t *p, qint64 absMs) {
+        qint64 seconds = absMs / 1000;
+        p = writeNumber(p, seconds / 60);
+        *p++ = u':';
+        return writeTwoDigits(p, int(seconds % 60));
+    }
+};
+
+template <>
+struct Spec<TimeLayout::HoursMinutesSeconds> {
+    static constexpr qint64 StepMs = 1000;
+    static char16_t *write(char16_t *p, qint64 absMs) {
+        qint64 seconds = absMs / 1000;
+        qint64 hours = seconds / 3600;
+        if (hours < 10) {
+            *p++ = char16_t(u'0' + hours);
+        } else {
+            p = writeNumber(p, hours);
+        }
+        *p++ = u':';
+        p = writeTwoDigits(p, int(seconds / 60 % 60));
+        *p++ = u':';
+        return writeTwoDigits(p, int(seconds % 60));
+    }
+};
+
+template <>
+struct Spec<TimeLayout::MinutesSecondsTenths> {
+    static constexpr qint64 StepMs = 100;
+    static char16_t *write(char16_t *p, qint64 absMs) {
+        p = Spec<TimeLayout::MinutesSeconds>::write(p, absMs);
+        *p++ = u'.';
+        *p++ = char16_t(u'0' + absMs / 100 % 10);
+        return p;
+    }
+};
+
+template <>
+struct Spec<TimeLayout::SecondsTenths> {
+    static constexpr qint64 StepMs = 100;
+    static char16_t *write(char16_t *p, qint64 absMs) {
+        p = writeNumber(p, absMs / 1000);
+        *p++ = u'.';
+        *p++ = char16_t(u'0' + absMs / 100 % 10);
+        return p;
+    }
+};
+
+// Writes the text for ms into out (MaxLength chars) and returns its
+// length. Uses no heap memory. Anything below zero gets the sign
+// (including -00:00).
+template <TimeLayout Layout, OvertimeSign Sign>
+int format(char16_t *out, qint64 ms) {
+    char16_t *p = out;
+    if (ms < 0) *p++ = Sign == OvertimeSign::Plus ? u'+' : u'-';
+    p = Spec<Layout>::write(p, ms < 0 ? -ms : ms);
+    return int(p - out);
+}
+
+// A format(), chosen once per configured segment rather than per value
+using Formatter = int (*)(char16_t *out, qint64 ms);
+
+template <OvertimeSign Sign>
+constexpr Formatter formatterFor(TimeLayout layout) {
+    switch (layout) {
+    case TimeLayout::HoursMinutesSeconds: return &format<TimeLayout::HoursMinutesSeconds, Sign>;
+    case TimeLayout::MinutesSecondsTenths: return &format<TimeLayout::MinutesSecondsTenths, Sign>;
+    case TimeLayout::SecondsTenths: return &format<TimeLayout::SecondsTenths, Sign>;
+    default: return &format<TimeLayout::MinutesSeconds, Sign>;
+    }
+}
+
+constexpr Formatter formatterFor(TimeLayout layout, OvertimeSign sign) {
+    return sign == OvertimeSign::Plus ? formatterFor<OvertimeSign::Plus>(layout)
+                                      : formatterFor<OvertimeSign::Minus>(layout);
+}
+
+inline int formatInto(char16_t *out, qint64 ms, TimeLayout layout,
+                      OvertimeSign sign = OvertimeSign::Minus) {
+    return formatterFor(layout, sign)(out, ms);
+}
+
+// Milliseconds per displayed step of a layout
+constexpr qint64 stepMs(TimeLayout layout) {
+    switch (layout) {
+    case TimeLayout::MinutesSecondsTenths: return Spec<TimeLayout::MinutesSecondsTenths>::StepMs;
+    case TimeLayout::SecondsTenths: return Spec<TimeLayout::SecondsTenths>::StepMs;
+    default: return Spec<TimeLayout::MinutesSeconds>::StepMs;
+    }
+}
+
+constexpr bool hasTenths(TimeLayout layout) {
+    return stepMs(layout) < 1000;
+}
+
+} // namespace TimeFormat
+
+// "mm:ss", with a leading '-' for anything below zero (including -00:00).
+// Whole seconds are truncated, matching how the countdown turns over.
+inline QString formatCountdown(qint64 ms, TimeLayout layout = TimeLayout::MinutesSeconds,
+                               OvertimeSign sign = OvertimeSign::Minus) {
+    char16_t buffer[TimeFormat::MaxLength];
+    int length = TimeFormat::formatInto(buffer, ms, layout, sign);
+    return QString(reinterpret_cast<const QChar *>(buffer), length);
+}
+
+// hh:mm:ss once either end of the countdown is an hour or more away
+inline TimeLayout timeLayoutFor(qint64 startMs, qint64 limitMs) {
+    const qint64 hourMs = 3600 * 1000;
+    return (startMs >= hourMs || -limitMs >= hourMs) ? TimeLayout::HoursMinutesSeconds
+                                                    : TimeLayout::MinutesSeconds;
+}
+
+// The widest text a countdown between startMs and limitMs can show, for
+// sizing the font: the value furthest from zero with every digit an 8 and
+// the sign in front. Seconds and minutes grow past 99 when they need to,
+// so a fixed "88.8" would not do.
+inline QString widestCountdownText(qint64 startMs, qint64 limitMs, TimeLayout layout,
+                                   OvertimeSign sign = OvertimeSign::Minus) {
+    char16_t buffer[TimeFormat::MaxLength];
+    buffer[0] = sign == OvertimeSign::Plus ? u'+' : u'-';
+    qint64 furthest = qMax(qAbs(startMs), qAbs(limitMs));
+    int length = 1 + TimeFormat::formatInto(buffer + 1, furthest, layout, sign);
+    for (int i = 1; i < length; ++i) {
+        if (buffer[i] >= u'0' && buffer[i] <= u'9') buffer[i] = u'8';
+    }
+    return QString(reinterpret_cast<const QChar *>(buffer), length);
+}
+
+// A segment's display format as chosen in config.txt
+struct DisplayFormat {
+    bool automatic = true; // mm:ss, or h:mm:ss once an end is an hour away
+    TimeLayout layout = TimeLayout::MinutesSeconds; // When not automatic
+    OvertimeSign overtime = OvertimeSign::Minus;
+
+    TimeLayout layoutFor(qint64 startMs, qint64 limitMs) const {
+        return automatic ? timeLayoutFor(startMs, limitMs) : layout;
+    }
+    bool operator==(const DisplayFormat &other) const {
+        return automatic == other.automatic && layout == other.layout
+               && overtime == other.overtime;
+    }
+};
+
+// Every text a countdown can show between its start and its limit,
+// formatted once when the timer is configured. On the tick path text() is
+// an index into this table: no formatting and no allocation, and the
+// returned string is shared with the widget instead of copied.
+class CountdownTextTable {
+public:
+    // The table is as long as the configured range. Only ranges beyond
+    // this many steps (about 2.7 h of tenths, 27 h of seconds) are not
+    // interned; values outside the table are formatted on demand.
+    static constexpr int MaxEntries = 100000;
+
+    // Rebuilds only if the range or format actually changed
+    void build(qint64 startMs, qint64 limitMs, TimeLayout layout,
+               OvertimeSign sign = OvertimeSign::Minus);
+
+    TimeLayout layout() const { return tableLayout; }
+    const QString &text(qint64 ms);
+
+private:
+    TimeLayout tableLayout = TimeLayout::MinutesSeconds;
+    OvertimeSign tableSign = OvertimeSign::Minus;
+    TimeFormat::Formatter formatter = TimeFormat::formatterFor(TimeLayout::MinutesSeconds,
+                                                                OvertimeSign::Minus);
+    qint64 step = 1000;
+    qint64 firstSlot = 0;
+    QVector<QString> texts; // texts[i] shows slot firstSlot + i
+    QString fallback;
+
+    // Distinct displayed values map to consecutive integers; negative
+    // values sit below zero with -00:00 at -1.
+    qint64 slotFor(qint64 ms) const;
+};
+
+#endif // TIMEFORMAT_H
@@ -0,0 +1,344 @@
+#include "timerconfig.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+// One meaningful line of config text. Everything is a view into the
+// original buffer, so tokenizing allocates nothing.
+struct ConfigLine {
+    int number = 0;
+    QStringView key;   // Empty for positional (old-style) lines
+    QStringView value;
+};
+
+class ConfigTokenizer {
+public:
+    explicit ConfigTokenizer(QStringView text) : rest(text) {}
+
+    // Next non-blank line with its comment stripped; false at the end
+    bool next(ConfigLine *line) {
+        while (!rest.isEmpty()) {
+            qsizetype newline = rest.indexOf(QChar('\n'));
+            QStringView raw = newline < 0 ? rest : rest.left(newline);
+            rest = newline < 0 ? QStringView() : rest.mid(newline + 1);
+            lineNumber++;
+
+            qsizetype hash = raw.indexOf(QChar('#'));
+            if (hash >= 0) raw = raw.left(hash);
+            raw = raw.trimmed(); // Also drops the '\r' of CRLF files
+            if (raw.isEmpty()) continue;
+
+            line->number = lineNumber;
+            qsizetype equals = raw.indexOf(QChar('='));
+            if (equals >= 0) {
+                line->key = raw.left(equals).trimmed();
+                line->value = raw.mid(equals + 1).trimmed();
+            } else {
+                line->key = QStringView();
+                line->value = raw;
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    QStringView rest;
+    int lineNumber = 0;
+};
+
+// "mm:ss", "h:mm:ss" or plain minutes; a leading '-' is allowed and ignored
+bool parseDuration(QStringView text, int *minutes, int *seconds) {
+    if (text.startsWith(QChar('-'))) text = text.mid(1).trimmed();
+    if (text.isEmpty()) return false;
+
+    int parts[3] = { 0, 0, 0 };
+    int count = 0;
+    while (true) {
+        if (count == 3) return false;
+        qsizetype colon = text.indexOf(QChar(':'));
+        QStringView part = colon < 0 ? text : text.left(colon);
+        bool ok = false;
+        parts[count++] = part.toInt(&ok);
+        if (!ok || parts[count - 1] < 0) return false;
+        if (colon < 0) break;
+        text = text.mid(colon + 1);
+    }
+
+    switch (count) {
+    case 1: // Minutes only
+        *minutes = parts[0];
+        *seconds = 0;
+        return true;
+    case 2: // mm:ss
+        if (parts[1] > 59) return false;
+        *minutes = parts[0];
+        *seconds = parts[1];
+        return true;
+    default: // h:mm:ss
+        if (parts[1] > 59 || parts[2] > 59) return false;
+        *minutes = parts[0] * 60 + parts[1];
+        *seconds = parts[2];
+        return true;
+    }
+}
+
+void addError(QStringList *errors, int line, const QString &message) {
+    if (errors) errors->append(QString("line %1: %2").arg(line).arg(message));
+}
+
+// --- Compiled snapshot ---
+// A binary copy of the parsed config, valid while the source file has the
+// same modification time and size, or failing that the same content hash.
+
+const quint32 SnapshotMagic = 0x43444346; // "CDCF"
+const quint32 SnapshotVersion = 5;
+
+QString snapshotPath(const QString &fileName) {
+    return fileName + ".snapshot";
+}
+
+struct SnapshotHeader {
+    qint64 sourceMtime = 0;
+    qint64 sourceSize = 0;
+    QByteArray sourceHash;
+};
+
+} // namespace
+
+// Outside the anonymous namespace: QList's stream operators only find the
+// element's through argument-dependent lookup
+QDataStream &operator<<(QDataStream &out, const TimerWarning &warning) {
+    return out << warning.atMs << warning.soundFile;
+}
+
+QDataStream &operator>>(QDataStream &in, TimerWarning &warning) {
+    return in >> warning.atMs >> warning.soundFile;
+}
+
+QDataStream &operator<<(QDataStream &out, const TimerSegment &segment) {
+    return out << segment.name << segment.startMin << segment.startSec
+               << segment.limitMin << segment.limitSec
+               << segment.soundZeroFile << segment.soundLimitFile << segment.endAt
+               << segment.precisionSec << segment.format.automatic
+               << quint8(segment.format.layout) << quint8(segment.format.overtime)
+               << segment.warnings;
+}
+
+QDataStream &operator>>(QDataStream &in, TimerSegment &segment) {
+    in >> segment.name >> segment.startMin >> segment.startSec
+              >> segment.limitMin >> segment.limitSec
+              >> segment.soundZeroFile >> segment.soundLimitFile >> segment.endAt
+              >> segment.precisionSec >> segment.format.automatic;
+    quint8 layout = 0;
+    quint8 overtime = 0;
+    in >> layout >> overtime >> segment.warnings;
+    segment.format.layout = TimeLayout(layout);
+    segment.format.overtime = OvertimeSign(overtime);
+    return in;
+}
+
+namespace {
+
+bool readSnapshot(const QString &path, SnapshotHeader *header, TimerConfig *config) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != SnapshotMagic || version != SnapshotVersion) return false;
+
+    in >> header->sourceMtime >> header->sourceSize >> header->sourceHash;
+    in >> static_cast<TimerSegment &>(*config) >> config->segments;
+    return in.status() == QDataStream::Ok;
+}
+
+void writeSnapshot(const QString &path, const SnapshotHeader &header, const TimerConfig &config) {
+    // Best effort: a read-only config directory just means no fast path
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << SnapshotMagic << SnapshotVersion;
+    out << header.sourceMtime << header.sourceSize << header.sourceHash;
+    out << static_cast<const TimerSegment &>(config) << config.segments;
+    file.commit();
+}
+
+} // namespace
+
+TimerConfig TimerConfig::parse(QStringView text, QStringList *errors) {
+    TimerConfig config;
+    TimerSegment *target = &config; // The current playlist segment, once there is one
+    ConfigTokenizer tokenizer(text);
+    ConfigLine line;
+    int position = 0; // Next positional value
+    int warningsOf = -1; // Segment whose own warning lines have started; -1 for the shared ones
+
+    auto readInt = [&](int *field) {
+        bool ok = false;
+        int value = line.value.toInt(&ok);
+        if (!ok || value < 0) {
+            addError(errors, line.number, QString("expected a whole number, got \"%1\"")
+                                              .arg(line.value.toString()));
+            return;
+        }
+        *field = value;
+    };
+
+    while (tokenizer.next(&line)) {
+        if (line.key.isEmpty()) {
+            if (target != &config) {
+                addError(errors, line.number, "positional values must come before the first segment");
+                continue;
+            }
+            switch (position++) {
+            case 0: readInt(&config.startMin); break;
+            case 1: readInt(&config.startSec); break;
+            case 2: readInt(&config.limitMin); break;
+            case 3: readInt(&config.limitSec); break;
+            case 4: config.soundZeroFile = line.value.toString(); break;
+            case 5: config.soundLimitFile = line.value.toString(); break;
+            default:
+                addError(errors, line.number, "unexpected extra value");
+                break;
+            }
+            continue;
+        }
+
+        if (line.key == QLatin1String("segment")) {
+            // Starts from the shared settings, never from the previous segment
+            config.segments.append(static_cast<const TimerSegment &>(config));
+            target = &config.segments.last();
+            target->name = line.value.toString();
+        } else if (line.key == QLatin1String("start")) {
+            if (!parseDuration(line.value, &target->startMin, &target->startSec)) {
+                addError(errors, line.number, "start must look like 40:00");
+            }
+        } else if (line.key == QLatin1String("stop")) {
+            if (!parseDuration(line.value, &target->limitMin, &target->limitSec)) {
+                addError(errors, line.number, "stop must look like 15:00");
+            }
+        } else if (line.key == QLatin1String("end_at")) {
+            QString value = line.value.toString();
+            target->endAt = QTime::fromString(value, "H:mm");
+            if (!target->endAt.isValid()) target->endAt = QTime::fromString(value, "H:mm:ss");
+            if (!target->endAt.isValid()) {
+                addError(errors, line.number, "end_at must be a time of day like 14:30");
+            }
+        } else if (line.key == QLatin1String("precision")) {
+            bool ok = false;
+            int seconds = line.value.toInt(&ok);
+            if (ok && seconds >= 0) {
+                target->precisionSec = seconds;
+            } else {
+                addError(errors, line.number, "precision must be a number of seconds like 10");
+            }
+        } else if (line.key == QLatin1String("format")) {
+            if (line.value == QLatin1String("auto")) {
+                target->format.automatic = true;
+            } else if (line.value == QLatin1String("mm:ss")) {
+                target->format.automatic = false;
+                target->format.layout = TimeLayout::MinutesSeconds;
+            } else if (line.value == QLatin1String("h:mm:ss")) {
+                target->format.automatic = false;
+                target->format.layout = TimeLayout::HoursMinutesSeconds;
+            } else if (line.value == QLatin1String("ss.t")) {
+                target->format.automatic = false;
+                target->format.layout = TimeLayout::SecondsTenths;
+            } else {
+                addError(errors, line.number, "format must be auto, mm:ss, h:mm:ss or ss.t");
+            }
+        } else if (line.key == QLatin1String("overtime")) {
+            if (line.value == QLatin1String("-") || line.value == QLatin1String("minus")) {
+                target->format.overtime = OvertimeSign::Minus;
+            } else if (line.value == QLatin1String("+") || line.value == QLatin1String("plus")) {
+                target->format.overtime = OvertimeSign::Plus;
+            } else {
+                addError(errors, line.number, "overtime must be - or +");
+            }
+        } else if (line.key == QLatin1String("warning")) {
+            QStringView value = line.value;
+            qsizetype space = value.indexOf(QChar(' '));
+            QStringView time = space < 0 ? value : value.left(space);
+            int minutes = 0;
+            int seconds = 0;
+            if (!parseDuration(time, &minutes, &seconds)) {
+                addError(errors, line.number, "warning must look like 5:00 or -5:00, then a sound file");
+                continue;
+            }
+            // The first warning of a segment replaces the inherited list
+            int current = target == &config ? -1 : int(config.segments.size()) - 1;
+            if (current != warningsOf) {
+                target->warnings.clear();
+                warningsOf = current;
+            }
+            TimerWarning warning;
+            warning.atMs = ((minutes * 60) + seconds) * 1000LL;
+            if (time.startsWith(QChar('-'))) warning.atMs = -warning.atMs;
+            if (space >= 0) warning.soundFile = value.mid(space + 1).trimmed().toString();
+            target->warnings.append(warning);
+        } else if (line.key == QLatin1String("sound_zero")) {
+            target->soundZeroFile = line.value.toString();
+        } else if (line.key == QLatin1String("sound_limit")) {
+            target->soundLimitFile = line.value.toString();
+        } else {
+            addError(errors, line.number, QString("unknown key \"%1\"").arg(line.key.toString()));
+        }
+    }
+
+    return config;
+}
+
+TimerConfig TimerConfig::load(const QString &fileName, QStringList *errors) {
+    QFileInfo source(fileName);
+    if (!source.exists()) return TimerConfig();
+
+    SnapshotHeader current;
+    current.sourceMtime = source.lastModified().toMSecsSinceEpoch();
+    current.sourceSize = source.size();
+
+    // Fast path: unchanged file, no need to even read it
+    SnapshotHeader cached;
+    TimerConfig config;
+    bool haveSnapshot = readSnapshot(snapshotPath(fileName), &cached, &config);
+    if (haveSnapshot && cached.sourceMtime == current.sourceMtime
+        && cached.sourceSize == current.sourceSize) {
+        return config;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errors) errors->append(QString("cannot read %1: %2").arg(fileName, file.errorString()));
+        return TimerConfig();
+    }
+    QByteArray bytes = file.readAll();
+    file.close();
+    current.sourceHash = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+
+    // Touched but identical (e.g. copied or checked out again)
+    if (haveSnapshot && cached.sourceHash == current.sourceHash) {
+        writeSnapshot(snapshotPath(fileName), current, config);
+        return config;
+    }
+
+    QStringList parseErrors;
+    QString text = QString::fromUtf8(bytes);
+    config = parse(text, &parseErrors);
+
+    // Only cache clean configs, so problems are reported on every start
+    if (parseErrors.isEmpty()) {
+        writeSnapshot(snapshotPath(fileName), current, config);
+    } else if (errors) {
+        errors->append(parseErrors);
+    }
+    return config;
+}
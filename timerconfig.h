@@ -0,0 +1,90 @@
+#ifndef TIMERCONFIG_H
+#define TIMERCONFIG_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QTime>
+
+#include "countdownclock.h"
+#include "timeformat.h"
+
+class QDataStream;
+
+// "warning = 5:00 warning.mp3": an extra cue when the countdown shows
+// atMs (negative past zero). Without a sound file it beeps.
+struct TimerWarning {
+    qint64 atMs = 0;
+    QString soundFile;
+
+    bool operator==(const TimerWarning &other) const {
+        return atMs == other.atMs && soundFile == other.soundFile;
+    }
+};
+
+// One countdown: where it starts, where it stops and which sounds it plays
+struct TimerSegment {
+    QString name; // "segment = Talk"; empty outside a playlist
+    int startMin = 0;
+    int startSec = 10;
+    int limitMin = 0;
+    int limitSec = 10;
+    QString soundZeroFile;
+    QString soundLimitFile;
+    QTime endAt; // "end_at = 14:30": count down to a time of day instead of startMin/startSec
+    int precisionSec = 0; // Show tenths this many seconds before zero and before the stop time
+    DisplayFormat format; // "format = h:mm:ss", "overtime = +"
+    QList<TimerWarning> warnings; // In config.txt order; a segment's own replace the shared ones
+
+    qint64 startMs() const {
+        if (endAt.isValid()) return WallClock::msUntil(endAt);
+        return ((startMin * 60) + startSec) * 1000;
+    }
+    qint64 limitMs() const { return -1 * ((limitMin * 60) + limitSec) * 1000; }
+
+    bool sameTiming(const TimerSegment &other) const {
+        return startMin == other.startMin && startSec == other.startSec
+               && limitMin == other.limitMin && limitSec == other.limitSec
+               && endAt == other.endAt && precisionSec == other.precisionSec
+               && format == other.format;
+    }
+};
+
+// For the compiled config snapshot
+QDataStream &operator<<(QDataStream &out, const TimerWarning &warning);
+QDataStream &operator>>(QDataStream &in, TimerWarning &warning);
+QDataStream &operator<<(QDataStream &out, const TimerSegment &segment);
+QDataStream &operator>>(QDataStream &in, TimerSegment &segment);
+
+// Settings read from config.txt (see README.md for the format)
+//
+// Two layouts are accepted, and may be mixed:
+//  - keyed lines such as "start = 40:00" or "sound_zero = sound_zero.mp3"
+//  - the original positional layout: start minutes, start seconds, stop
+//    minutes, stop seconds, zero sound, limit sound, one value per line
+//
+// Each "segment = name" line starts a playlist entry. It inherits every
+// setting given before the first segment, and the keys below it override
+// them for that segment only.
+struct TimerConfig : TimerSegment {
+    QList<TimerSegment> segments; // Empty unless config.txt is a playlist
+
+    int segmentCount() const { return segments.isEmpty() ? 1 : int(segments.size()); }
+    // The countdown to run for a playlist position; the plain settings
+    // above when there is no playlist
+    TimerSegment segment(int index) const {
+        if (segments.isEmpty()) return *this;
+        return segments.at(qBound(0, index, int(segments.size()) - 1));
+    }
+
+    // Loads fileName, or the compiled snapshot next to it ("<file>.snapshot")
+    // when that is still up to date. Problems are appended to errors as
+    // "line N: message"; a missing file returns the defaults above.
+    static TimerConfig load(const QString &fileName, QStringList *errors = nullptr);
+
+    // Parses config text without touching the disk
+    static TimerConfig parse(QStringView text, QStringList *errors = nullptr);
+};
+
+#endif // TIMERCONFIG_H
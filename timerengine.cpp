@@ -0,0 +1,271 @@
+#include "timerengine.h"
+
+#include <limits>
+
+TimerEngine::TimerEngine(QObject *parent)
+    : QObject(parent), clockSource(new SteadyClock) {
+    ticker = new TickScheduler(this);
+    connect(ticker, &TickScheduler::tick, this, &TimerEngine::onTick);
+}
+
+void TimerEngine::setClock(std::unique_ptr<CountdownClock> newClock) {
+    qint64 oldNow = clockSource->nowMs();
+    qint64 newNow = newClock->nowMs();
+    for (int i = 0; i < timerCount(); ++i) {
+        if (flags[i] & Running) {
+            targetEndTime[i] = newNow + (targetEndTime[i] - oldNow);
+        }
+    }
+    clockSource = std::move(newClock);
+}
+
+void TimerEngine::clockStepped(qint64 deltaMs) {
+    for (int i = 0; i < timerCount(); ++i) {
+        if (flags[i] & Running) targetEndTime[i] += deltaMs;
+    }
+    if (runningCount == 0) return;
+    scheduleNextTick();
+    // Deadlines taken from targetEndTime (the cue thread's) need redoing
+    for (TimerId id = 0; id < timerCount(); ++id) {
+        if (flags[id] & Running) emit stateChanged(id);
+    }
+}
+
+TimerEngine::TimerId TimerEngine::addTimer(qint64 start, qint64 limit) {
+    TimerId id = timerCount();
+    startMs.append(start);
+    limitMs.append(limit);
+    currentMs.append(start);
+    targetEndTime.append(0);
+    flags.append(Visible);
+    // Doubling, so adding many timers is not a reallocation each
+    if (zeroHits.capacity() < timerCount()) {
+        zeroHits.reserve(2 * timerCount());
+        limitHits.reserve(2 * timerCount());
+    }
+    return id;
+}
+
+void TimerEngine::configure(TimerId id, qint64 start, qint64 limit) {
+    startMs[id] = start;
+    limitMs[id] = limit;
+}
+
+void TimerEngine::reset(TimerId id) {
+    if (flags[id] & Running) runningCount--;
+    flags[id] &= Visible;
+    currentMs[id] = startMs[id];
+    if (runningCount == 0) ticker->stop();
+    emit stateChanged(id);
+}
+
+void TimerEngine::start(TimerId id) {
+    if ((flags[id] & Running) || (flags[id] & LimitHit)) return;
+
+    flags[id] = (flags[id] | Running) & ~Paused;
+    targetEndTime[id] = clockSource->nowMs() + currentMs[id];
+    runningCount++;
+    scheduleNextTick();
+    emit stateChanged(id);
+}
+
+void TimerEngine::pause(TimerId id) {
+    if (!(flags[id] & Running)) return;
+
+    // Freeze the remaining time exactly where it is now
+    currentMs[id] = targetEndTime[id] - clockSource->nowMs();
+    flags[id] = (flags[id] | Paused) & ~Running;
+    runningCount--;
+    if (runningCount == 0) {
+        ticker->stop();
+    } else {
+        scheduleNextTick();
+    }
+    emit stateChanged(id);
+}
+
+void TimerEngine::adjust(TimerId id, qint64 deltaMs) {
+    if (flags[id] & LimitHit) return;
+
+    qint64 now = clockSource->nowMs();
+    qint64 remaining = qMax(remainingAt(id, now) + deltaMs, limitMs[id]);
+    currentMs[id] = remaining;
+    if (flags[id] & Running) targetEndTime[id] = now + remaining;
+
+    // Crossings are settled here rather than on the next advance, which
+    // for a paused timer may never come
+    bool zeroHit = remaining <= 0 && !(flags[id] & ZeroPlayed);
+    bool limitHit = remaining <= limitMs[id];
+    if (remaining > 0) flags[id] &= ~ZeroPlayed;
+    if (zeroHit) flags[id] |= ZeroPlayed;
+    if (limitHit) {
+        if (flags[id] & Running) runningCount--;
+        flags[id] = (flags[id] | LimitHit | Paused) & ~Running;
+    }
+
+    scheduleNextTick();
+    emit stateChanged(id);
+    if (zeroHit) emit zeroReached(id);
+    if (limitHit) emit limitReached(id);
+    emit ticked();
+}
+
+void TimerEngine::seek(TimerId id, qint64 remainingMs) {
+    adjust(id, remainingMs - remainingAt(id, clockSource->nowMs()));
+}
+
+void TimerEngine::setVisible(TimerId id, bool visible) {
+    bool wasVisible = flags[id] & Visible;
+    if (visible == wasVisible) return;
+
+    if (visible) {
+        flags[id] |= Visible;
+    } else {
+        flags[id] &= ~Visible;
+    }
+    updateTickMode();
+}
+
+CountdownState TimerEngine::state(TimerId id) const {
+    CountdownState s;
+    s.startMs = startMs[id];
+    s.limitMs = limitMs[id];
+    s.currentMs = currentMs[id];
+    s.targetEndTime = targetEndTime[id];
+    s.isRunning = flags[id] & Running;
+    s.isPaused = flags[id] & Paused;
+    s.zeroSoundPlayed = flags[id] & ZeroPlayed;
+    s.limitReached = flags[id] & LimitHit;
+    return s;
+}
+
+void TimerEngine::advance(qint64 nowMs) {
+    zeroHits.clear();
+    limitHits.clear();
+
+    const int count = timerCount();
+    const quint8 *f = flags.constData();
+    for (int i = 0; i < count; ++i) {
+        if (!(f[i] & Running)) continue;
+
+        qint64 remaining = targetEndTime[i] - nowMs;
+        if (remaining <= 0 && !(f[i] & ZeroPlayed)) {
+            zeroHits.append(i);
+        }
+        if (remaining <= limitMs[i]) {
+            remaining = limitMs[i];
+            limitHits.append(i);
+        }
+        currentMs[i] = remaining;
+    }
+
+    // Apply state changes before any handler runs
+    for (TimerId id : zeroHits) {
+        flags[id] |= ZeroPlayed;
+    }
+    for (TimerId id : limitHits) {
+        flags[id] = (flags[id] | LimitHit | Paused) & ~Running;
+        runningCount--;
+    }
+
+    for (TimerId id : zeroHits) emit zeroReached(id);
+    for (TimerId id : limitHits) {
+        emit limitReached(id);
+        emit stateChanged(id);
+    }
+    emit ticked();
+}
+
+void TimerEngine::applySnapshot(TimerId id, const CountdownState &s) {
+    bool wasRunning = flags[id] & Running;
+
+    startMs[id] = s.startMs;
+    limitMs[id] = s.limitMs;
+    currentMs[id] = s.currentMs;
+
+    quint8 f = flags[id] & Visible;
+    if (s.isRunning) f |= Running;
+    if (s.isPaused) f |= Paused;
+    if (s.zeroSoundPlayed) f |= ZeroPlayed;
+    if (s.limitReached) f |= LimitHit;
+    flags[id] = f;
+
+    if (s.isRunning) {
+        targetEndTime[id] = clockSource->nowMs() + s.currentMs;
+    }
+    runningCount += int(s.isRunning) - int(wasRunning);
+
+    scheduleNextTick();
+    emit stateChanged(id);
+    emit ticked();
+}
+
+void TimerEngine::onTick() {
+    currentTickLatenessUs = ticker->lastLatenessUs();
+    advance(clockSource->nowMs());
+    currentTickLatenessUs = -1;
+    scheduleNextTick();
+}
+
+void TimerEngine::scheduleNextTick() {
+    if (runningCount == 0) {
+        ticker->stop();
+        return;
+    }
+
+    qint64 now = clockSource->nowMs();
+    if (!anyVisible && idleWhenHidden) {
+        // Nothing to draw: sleep until the next zero or limit crossing
+        qint64 delay = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < timerCount(); ++i) {
+            if (!(flags[i] & Running)) continue;
+            qint64 remaining = targetEndTime[i] - now;
+            qint64 untilThreshold = (flags[i] & ZeroPlayed) ? remaining - limitMs[i] : remaining;
+            delay = qMin(delay, untilThreshold);
+        }
+        // QTimer takes an int; a very distant deadline just re-arms on waking
+        ticker->armIn(qMin<qint64>(delay, std::numeric_limits<int>::max()));
+        return;
+    }
+
+    // Wake for whichever running timer turns over its displayed second first
+    qint64 delay = 1000;
+    for (int i = 0; i < timerCount(); ++i) {
+        if (!(flags[i] & Running)) continue;
+        delay = qMin(delay, TickScheduler::msUntilNextSecond(targetEndTime[i] - now));
+    }
+    ticker->armIn(delay);
+}
+
+void TimerEngine::setIdleWhenHidden(bool idle) {
+    if (idle == idleWhenHidden) return;
+    idleWhenHidden = idle;
+    updateTickMode();
+    if (!anyVisible) scheduleNextTick();
+}
+
+void TimerEngine::updateTickMode() {
+    bool wasVisible = anyVisible;
+    anyVisible = false;
+    for (quint8 f : flags) {
+        if (f & Visible) {
+            anyVisible = true;
+            break;
+        }
+    }
+
+    // Threshold-only wakeups are rare and must be punctual, so they stay precise
+    TickScheduler::Mode mode = (anyVisible || idleWhenHidden) ? TickScheduler::Mode::Precise
+                                                              : TickScheduler::Mode::Coarse;
+    ticker->setMode(mode);
+    if (anyVisible == wasVisible || runningCount == 0) return;
+
+    if (anyVisible) {
+        // Coming back into view: catch the displays up now rather than
+        // waiting for the (possibly late or distant) next tick.
+        onTick();
+    } else if (idleWhenHidden) {
+        // Swap the pending per-second tick for the threshold deadline
+        scheduleNextTick();
+    }
+}
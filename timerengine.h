@@ -0,0 +1,132 @@
+#ifndef TIMERENGINE_H
+#define TIMERENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+#include "countdownclock.h"
+#include "tickscheduler.h"
+
+// Everything one countdown needs, independent of any widget.
+struct CountdownState {
+    qint64 startMs = 0;       // Value a reset returns to
+    qint64 limitMs = 0;       // Negative stop value (e.g. -15:00)
+    qint64 currentMs = 0;     // Remaining time, negative once past zero
+    qint64 targetEndTime = 0; // Clock time at which currentMs reaches 0 (while running)
+    bool isRunning = false;
+    bool isPaused = false;
+    bool zeroSoundPlayed = false;
+    bool limitReached = false;
+};
+
+// Advances any number of countdowns from a single tick source and clock.
+// Timers are stored structure-of-arrays, so one tight pass over contiguous
+// arrays updates every running timer and checks every zero/limit threshold.
+// Threshold events are emitted after the pass, so handlers may freely call
+// back into the engine.
+class TimerEngine : public QObject {
+    Q_OBJECT
+
+public:
+    using TimerId = int;
+
+    explicit TimerEngine(QObject *parent = nullptr);
+
+    // Swap the time source (e.g. a ManualClock for benchmarks). Running
+    // timers keep their remaining time across the switch.
+    void setClock(std::unique_ptr<CountdownClock> newClock);
+    const CountdownClock &clock() const { return *clockSource; }
+    // The clock's own timeline has just jumped by deltaMs (a time-sync
+    // step): move every running timer's end time with it, so remaining
+    // times carry on unchanged.
+    void clockStepped(qint64 deltaMs);
+
+    TimerId addTimer(qint64 startMs, qint64 limitMs);
+    int timerCount() const { return int(currentMs.size()); }
+
+    // Change start/limit values. The start is only shown from the next
+    // reset(); the limit applies at once, a running countdown included
+    // (the next advance checks against it).
+    void configure(TimerId id, qint64 startMs, qint64 limitMs);
+    void reset(TimerId id);
+    void start(TimerId id);
+    void pause(TimerId id);
+    // Add deltaMs to the remaining time (negative takes time away), running
+    // or not, but never past the limit. Reaching zero or the limit this way
+    // emits zeroReached/limitReached before returning, after stateChanged;
+    // moving back above zero re-arms the zero cue.
+    void adjust(TimerId id, qint64 deltaMs);
+    // Jump to remainingMs the same way: only the end time moves, so
+    // nothing restarts
+    void seek(TimerId id, qint64 remainingMs);
+
+    // Tick precisely while any timer is on screen, coarsely otherwise.
+    void setVisible(TimerId id, bool visible);
+    // With nothing on screen, stop the per-second ticks altogether and wake
+    // only when the next running timer reaches zero or its limit, so cues
+    // still fire on time. Off by default (headless output needs the ticks).
+    void setIdleWhenHidden(bool idle);
+
+    CountdownState state(TimerId id) const;
+    qint64 remainingMs(TimerId id) const { return currentMs[id]; }
+    // Exact remaining time at nowMs, without waiting for the next advance
+    qint64 remainingAt(TimerId id, qint64 nowMs) const {
+        return (flags[id] & Running) ? targetEndTime[id] - nowMs : currentMs[id];
+    }
+    bool isRunning(TimerId id) const { return flags[id] & Running; }
+
+    // While ticked() is being emitted for a scheduled tick: how late that
+    // tick fired, in us. -1 for advances not driven by the tick timer.
+    qint64 tickLatenessUs() const { return currentTickLatenessUs; }
+
+    // Take over a state that was produced elsewhere (another machine, a
+    // saved session). s.currentMs is the remaining time right now; when
+    // s.isRunning, targetEndTime is re-anchored on this engine's clock.
+    void applySnapshot(TimerId id, const CountdownState &s);
+
+    // Bring every running timer up to nowMs in one pass and emit the
+    // crossed thresholds. Does not touch the tick schedule.
+    void advance(qint64 nowMs);
+
+signals:
+    void zeroReached(TimerEngine::TimerId id);
+    void limitReached(TimerEngine::TimerId id);
+    void ticked(); // After every advance, once the thresholds have been handled
+    // Start, pause, reset, limit reached or snapshot applied: anything
+    // other than the normal passage of time.
+    void stateChanged(TimerEngine::TimerId id);
+
+private:
+    enum Flag : quint8 {
+        Running = 0x01,
+        Paused = 0x02,
+        ZeroPlayed = 0x04,
+        LimitHit = 0x08,
+        Visible = 0x10
+    };
+
+    std::unique_ptr<CountdownClock> clockSource;
+    TickScheduler *ticker;
+
+    // One entry per timer, indexed by TimerId
+    QVector<qint64> startMs;
+    QVector<qint64> limitMs;
+    QVector<qint64> currentMs;
+    QVector<qint64> targetEndTime;
+    QVector<quint8> flags;
+    int runningCount = 0;
+    bool anyVisible = true;
+    bool idleWhenHidden = false;
+    qint64 currentTickLatenessUs = -1;
+
+    // Scratch lists reused by every pass so advancing never allocates
+    QVector<TimerId> zeroHits;
+    QVector<TimerId> limitHits;
+
+    void onTick();
+    void scheduleNextTick();
+    void updateTickMode();
+};
+
+#endif // TIMERENGINE_H
@@ -0,0 +1,92 @@
+#include "timermetrics.h"
+
+#include "processstats.h"
+
+namespace {
+
+// Single writer: a plain add without a read-modify-write instruction
+template <typename T>
+void bump(std::atomic<T> &value, T by) {
+    value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+struct Description {
+    const char *name;
+    const char *help;
+};
+
+const Description HistogramInfo[TimerMetrics::HistogramCount] = {
+    { "countdown_tick_lateness_seconds", "How late each scheduled tick fired." },
+    { "countdown_update_duration_seconds", "Time spent updating the display." },
+    { "countdown_cue_latency_seconds", "Cue deadline to the sound being handed to the audio device." },
+    { "countdown_config_reload_seconds", "Time to read, parse and apply config.txt." },
+};
+
+const Description CounterInfo[TimerMetrics::CounterCount] = {
+    { "countdown_repaints_total", "Window repaints." },
+    { "countdown_cues_missed_total", "Cues played as a beep because the sound was missing or undecodable." },
+    { "countdown_display_updates_total", "Display updates, skipped ones included." },
+    { "countdown_display_updates_skipped_total", "Display updates skipped because the text had not changed." },
+};
+
+QByteArray seconds(qint64 us) {
+    return QByteArray::number(double(us) / 1e6, 'g', 9);
+}
+
+void header(QByteArray &out, const Description &info, const char *type) {
+    out += QByteArray("# HELP ") + info.name + ' ' + info.help + '\n';
+    out += QByteArray("# TYPE ") + info.name + ' ' + type + '\n';
+}
+
+} // namespace
+
+void TimerMetrics::observe(Histogram histogram, qint64 valueUs) {
+    int bucket = 0;
+    while (bucket < BucketCount - 1 && valueUs > BucketBoundsUs[bucket]) bucket++;
+    Series &series = histograms[histogram];
+    bump<quint64>(series.buckets[bucket], 1);
+    bump<qint64>(series.sumUs, valueUs);
+}
+
+void TimerMetrics::increment(Counter counter) {
+    bump<quint64>(counters[counter], 1);
+}
+
+QByteArray TimerMetrics::prometheusText() const {
+    QByteArray out;
+    out.reserve(4096);
+
+    for (int h = 0; h < HistogramCount; ++h) {
+        const Description &info = HistogramInfo[h];
+        const Series &series = histograms[h];
+        header(out, info, "histogram");
+        quint64 cumulative = 0;
+        for (int bucket = 0; bucket < BucketCount; ++bucket) {
+            cumulative += series.buckets[bucket].load(std::memory_order_relaxed);
+            QByteArray bound = bucket < BucketCount - 1 ? seconds(BucketBoundsUs[bucket]) : "+Inf";
+            out += QByteArray(info.name) + "_bucket{le=\"" + bound + "\"} "
+                   + QByteArray::number(cumulative) + '\n';
+        }
+        // The count is the +Inf bucket, so the two can never disagree
+        out += QByteArray(info.name) + "_sum " + seconds(series.sumUs.load(std::memory_order_relaxed)) + '\n';
+        out += QByteArray(info.name) + "_count " + QByteArray::number(cumulative) + '\n';
+    }
+
+    for (int c = 0; c < CounterCount; ++c) {
+        header(out, CounterInfo[c], "counter");
+        out += QByteArray(CounterInfo[c].name) + ' '
+               + QByteArray::number(counters[c].load(std::memory_order_relaxed)) + '\n';
+    }
+
+    const Description memory[] = {
+        { "countdown_resident_memory_bytes", "Resident set size." },
+        { "countdown_peak_resident_memory_bytes", "Peak resident set size since start." },
+    };
+    const qint64 kb[] = { residentKb(), peakResidentKb() };
+    for (int i = 0; i < 2; ++i) {
+        if (kb[i] < 0) continue; // Not available on this platform
+        header(out, memory[i], "gauge");
+        out += QByteArray(memory[i].name) + ' ' + QByteArray::number(kb[i] * 1024) + '\n';
+    }
+    return out;
+}
@@ -0,0 +1,56 @@
+#ifndef TIMERMETRICS_H
+#define TIMERMETRICS_H
+
+#include <QByteArray>
+#include <atomic>
+
+// Always-on counters and histograms for fleet monitoring, scraped as
+// Prometheus text (see MetricsServer). Unlike TickStats, which keeps raw
+// samples for the overlay, this only buckets them, so memory stays fixed
+// however long a display runs and p99 comes from histogram_quantile().
+//
+// Every series has exactly one writing thread (the cue latency the cue
+// thread, the rest the GUI thread), so recording is a relaxed load and
+// store per bucket: no lock and no locked instruction. The scrape reads
+// the same atomics from its own thread and may see a sample half-way in,
+// which only ever shifts a count by one between two scrapes.
+class TimerMetrics {
+public:
+    enum Histogram {
+        TickLateness,   // Actual minus scheduled tick time
+        UpdateDuration, // Time spent in updateDisplay()
+        CueLatency,     // Cue deadline to the sound handed to the device
+        ConfigReload,   // Reading, parsing and applying config.txt
+        HistogramCount
+    };
+
+    enum Counter {
+        Repaints,       // Window repaints, mirrors excluded
+        CuesMissed,     // Cues that fell back to a beep
+        DisplayUpdates, // updateDisplay() calls that reached the render cache
+        SkippedUpdates, // Of those, the ones that left the text as it was
+        CounterCount
+    };
+
+    // Upper bucket bounds, in us, shared by every histogram; +Inf is implied
+    static constexpr qint64 BucketBoundsUs[] = { 500, 1000, 2000, 5000, 10000, 20000,
+                                                 50000, 100000, 200000, 500000, 1000000 };
+    static constexpr int BucketCount = int(sizeof(BucketBoundsUs) / sizeof(qint64)) + 1;
+
+    void observe(Histogram histogram, qint64 valueUs);
+    void increment(Counter counter);
+
+    // Text exposition format, version 0.0.4, including process memory
+    QByteArray prometheusText() const;
+
+private:
+    struct Series {
+        std::atomic<quint64> buckets[BucketCount] = {}; // Not cumulative
+        std::atomic<qint64> sumUs{0};
+    };
+
+    Series histograms[HistogramCount];
+    std::atomic<quint64> counters[CounterCount] = {};
+};
+
+#endif // TIMERMETRICS_H
@@ -0,0 +1,92 @@
+#include "timesync.h"
+
+#include <QNetworkDatagram>
+#include <QTimer>
+#include <QUdpSocket>
+
+#include "countdownclock.h"
+#include "timerengine.h"
+
+TimeSyncClient::TimeSyncClient(SyncedClock *clock, TimerEngine *engine, QObject *parent)
+    : QObject(parent), clock(clock), engine(engine) {
+    socket = new QUdpSocket(this);
+    socket->bind(QHostAddress::AnyIPv4, 0);
+    connect(socket, &QUdpSocket::readyRead, this, &TimeSyncClient::readReplies);
+
+    poll = new QTimer(this);
+    poll->setTimerType(Qt::PreciseTimer);
+    connect(poll, &QTimer::timeout, this, &TimeSyncClient::sendRequest);
+}
+
+void TimeSyncClient::follow(const QHostAddress &address, quint16 port, quint32 newSession) {
+    if (hasServer && newSession == session && address == server && port == serverPort) return;
+
+    hasServer = true;
+    server = address;
+    serverPort = port;
+    session = newSession;
+    synced = false;
+    generation++;
+    window.clear();
+    burstLeft = BurstCount;
+    poll->start(BurstIntervalMs);
+    sendRequest();
+}
+
+void TimeSyncClient::sendRequest() {
+    if (burstLeft > 0 && --burstLeft == 0) poll->start(PollIntervalMs);
+
+    StateWire::SyncPacket request;
+    request.generation = generation;
+    request.requestSentUs = clock->nowUs();
+    socket->writeDatagram(StateWire::encodeSync(request), server, serverPort);
+}
+
+void TimeSyncClient::readReplies() {
+    while (socket->hasPendingDatagrams()) {
+        QNetworkDatagram datagram = socket->receiveDatagram();
+        qint64 receivedUs = clock->nowUs();
+        StateWire::SyncPacket reply;
+        if (!StateWire::decodeSync(datagram.data(), &reply) || !reply.reply) continue;
+        // Replies from a publisher we no longer follow
+        if (datagram.senderAddress() != server) continue;
+        // Sent before the last step, whichever way it went
+        if (reply.generation != generation) continue;
+
+        qint64 t1 = reply.requestSentUs;
+        qint64 t2 = reply.requestReceivedUs;
+        qint64 t3 = reply.replySentUs;
+        qint64 t4 = receivedUs;
+        Sample sample;
+        // Kept relative to the local clock, so slews since don't age it
+        sample.offsetUs = clock->offsetUs() + ((t2 - t1) + (t3 - t4)) / 2;
+        sample.delayUs = (t4 - t1) - (t3 - t2);
+        if (sample.delayUs < 0) continue;
+        addSample(sample);
+    }
+}
+
+void TimeSyncClient::addSample(const Sample &sample) {
+    window.append(sample);
+    if (window.size() > WindowSize) window.removeFirst();
+
+    Sample best = window.first();
+    for (const Sample &candidate : window) {
+        if (candidate.delayUs < best.delayUs) best = candidate;
+    }
+
+    qint64 currentUs = clock->offsetUs();
+    qint64 errorUs = best.offsetUs - currentUs;
+    // While the first burst narrows things down, whole milliseconds are
+    // stepped too rather than slewed over several seconds
+    bool step = !synced || qAbs(errorUs) > StepThresholdUs
+                || (burstLeft > 0 && qAbs(errorUs) >= 1000);
+    if (step) {
+        clock->stepTo(best.offsetUs);
+        generation++;
+        engine->clockStepped((best.offsetUs - currentUs) / 1000);
+        synced = true;
+    } else {
+        clock->slewTo(best.offsetUs);
+    }
+}
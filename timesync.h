@@ -0,0 +1,69 @@
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QVector>
+
+#include "statebroadcast.h"
+
+class QTimer;
+class QUdpSocket;
+class SyncedClock;
+class TimerEngine;
+
+// Puts a follower's engine clock on the publisher's timeline, NTP style,
+// so packets can be taken at the time they were sent and every screen
+// shows the same tenth at the same moment.
+//
+// Each exchange gives an offset estimate ((t2 - t1) + (t3 - t4)) / 2 and a
+// round-trip delay (t4 - t1) - (t3 - t2). Of the last few samples the one
+// with the shortest delay is trusted, since queueing only ever adds to it.
+// Small corrections are slewed into the clock; the first one, and any
+// that a slew would take too long to cover, are stepped and the engine's
+// running timers moved with the clock.
+class TimeSyncClient : public QObject {
+    Q_OBJECT
+
+public:
+    TimeSyncClient(SyncedClock *clock, TimerEngine *engine, QObject *parent = nullptr);
+
+    // The publisher as seen from its state packets. A new session is a
+    // restarted publisher on a new timeline, so sync begins again.
+    void follow(const QHostAddress &address, quint16 port, quint32 session);
+    bool isSynced() const { return synced; }
+
+private:
+    static constexpr int BurstCount = 8;      // Quick exchanges after (re)starting
+    static constexpr int BurstIntervalMs = 250;
+    static constexpr int PollIntervalMs = 2000;
+    static constexpr int WindowSize = 8;
+    // Beyond this a slew at MaxSlewPpm takes minutes, so step instead
+    static constexpr qint64 StepThresholdUs = 100000;
+
+    struct Sample {
+        qint64 offsetUs = 0; // Publisher time minus local steady time
+        qint64 delayUs = 0;
+    };
+
+    SyncedClock *clock;
+    TimerEngine *engine;
+    QUdpSocket *socket;
+    QTimer *poll;
+    QHostAddress server;
+    quint16 serverPort = 0;
+    quint32 session = 0;
+    bool hasServer = false;
+    bool synced = false;
+    int burstLeft = 0;
+    // Bumped on every step (and new publisher); replies to requests from
+    // before it were timed on a timeline the clock has left
+    quint16 generation = 0;
+    QVector<Sample> window;
+
+    void sendRequest();
+    void readReplies();
+    void addSample(const Sample &sample);
+};
+
+#endif // TIMESYNC_H
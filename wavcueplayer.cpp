@@ -0,0 +1,53 @@
+#include "wavcueplayer.h"
+
+#include <QFile>
+
+#include "assets.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+WavCuePlayer::CueId WavCuePlayer::load(const QString &fileName, QString *error) {
+    if (fileName.isEmpty()) return InvalidCue;
+
+    // Embedded cues are used in place; files on disk are read once
+    QString path = Assets::locate(fileName);
+    QByteArray data = Assets::mapped(path);
+    QFile file(path);
+    if (data.isEmpty() && (path.isEmpty() || !file.open(QIODevice::ReadOnly))) {
+        if (error) *error = QString("sound file not found: %1").arg(fileName);
+        return InvalidCue;
+    }
+    if (data.isEmpty()) data = file.readAll();
+    if (data.size() < 12 || !data.startsWith("RIFF") || data.mid(8, 4) != "WAVE") {
+        if (error) *error = QString("the minimal build only plays WAV files: %1").arg(fileName);
+        return InvalidCue;
+    }
+    cues.append(data);
+    return CueId(cues.size() - 1);
+}
+
+bool WavCuePlayer::play(CueId id) {
+#ifdef Q_OS_WIN
+    if (id >= 0 && id < cues.size()) {
+        // The bytes stay alive in cues for as long as the sound can play
+        const QByteArray &data = cues.at(id);
+        if (PlaySoundW(reinterpret_cast<LPCWSTR>(data.constData()), nullptr,
+                       SND_MEMORY | SND_ASYNC | SND_NODEFAULT)) {
+            return true;
+        }
+    }
+    MessageBeep(MB_OK);
+#else
+    Q_UNUSED(id);
+#endif
+    return false;
+}
+
+void WavCuePlayer::stop() {
+#ifdef Q_OS_WIN
+    PlaySoundW(nullptr, nullptr, 0);
+#endif
+}
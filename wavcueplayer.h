@@ -0,0 +1,31 @@
+#ifndef WAVCUEPLAYER_H
+#define WAVCUEPLAYER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// The minimal build's audio: WAV cues read into memory once and handed to
+// the system player (winmm PlaySound on Windows), so the executable needs
+// neither Qt Multimedia nor a codec stack. Only one cue sounds at a time;
+// a new one cuts off the one before. Other formats, and other platforms,
+// fall back to the system beep.
+class WavCuePlayer {
+public:
+    using CueId = int;
+    static constexpr CueId InvalidCue = -1;
+
+    // Reads fileName once. Returns InvalidCue (with the reason in error)
+    // for a missing file or anything that is not a RIFF/WAVE file.
+    CueId load(const QString &fileName, QString *error = nullptr);
+
+    // Starts the cue and returns at once. False if there was nothing to
+    // play; on Windows it has then beeped instead.
+    bool play(CueId id);
+    void stop();
+
+private:
+    QList<QByteArray> cues;
+};
+
+#endif // WAVCUEPLAYER_H